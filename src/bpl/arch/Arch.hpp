@@ -25,6 +25,7 @@ namespace bpl  {
     template<typename A, typename B>  using pair        = NS (ARCH,__VA_ARGS__) pair<A,B>;      \
     template<class T, std::size_t N>  using array       = NS (ARCH,__VA_ARGS__) array<T,N>;     \
     template<class T>                 using allocator   = NS (ARCH,__VA_ARGS__) allocator<T>;   \
+    template<class T>                 using arena_allocator = NS (ARCH,__VA_ARGS__) arena_allocator<T>; \
     template<class T,typename Alloc=allocator<T>>  using vector      = NS (ARCH,__VA_ARGS__) vector<T,Alloc>;\
     template<class T>                 using span        = NS (ARCH,__VA_ARGS__) span<T>;        \
     template<class T>                 using vector_view = NS (ARCH,__VA_ARGS__) vector_view<T>; \
@@ -32,6 +33,10 @@ namespace bpl  {
     template<class T>                 using lock_guard  = NS (ARCH,__VA_ARGS__) lock_guard<T>;  \
     template<class T>                 using once        = NS (ARCH,__VA_ARGS__) once<T>;        \
     template<class T>                 using global      = NS (ARCH,__VA_ARGS__) global<T>;      \
+    template<class T>                 using output      = NS (ARCH,__VA_ARGS__) output<T>;      \
+    template<class T, class...OP>     using sharded     = NS (ARCH,__VA_ARGS__) sharded<T,OP...>;  \
+    template<class T>                 using counter     = NS (ARCH,__VA_ARGS__) counter<T>;     \
+    template<std::size_t N, class...T> using histogram  = NS (ARCH,__VA_ARGS__) histogram<N,T...>; \
     template<class T>                 using glonce      = NS (ARCH,__VA_ARGS__) global<NS (ARCH,__VA_ARGS__)once<T>>;\
                                       using string      = NS0(ARCH,__VA_ARGS__)::string;        \
                                       using size_t      = NS0(ARCH,__VA_ARGS__)::size_t;        \
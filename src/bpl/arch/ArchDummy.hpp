@@ -9,6 +9,7 @@
 #pragma once
 
 #include <bpl/arch/Arch.hpp>
+#include <bpl/utils/Sharded.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace bpl  {
@@ -41,6 +42,7 @@ struct ArchDummy
     template<typename T>        using vector_view = std::vector<T>;
 
     template<typename T>        using allocator = std:: allocator<T>;
+    template<typename T>        using arena_allocator = std:: allocator<T>;
 
     template<typename T>        using initializer_list = std::initializer_list<T>;
 
@@ -75,6 +77,12 @@ struct ArchDummy
 
     template<typename T> using once   = bpl::once<T>;
     template<typename T> using global = bpl::global<T>;
+    template<typename T> using output = bpl::output<T>;
+
+    // Accumulators updated by several process units without lock (see bpl::Sharded).
+    template<typename T, typename...OP>      using sharded   = bpl::Sharded<T,OP...>;
+    template<typename T>                     using counter   = bpl::Counter<T>;
+    template<std::size_t N, typename...T>    using histogram = bpl::Histogram<N,T...>;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
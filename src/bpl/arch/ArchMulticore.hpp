@@ -15,9 +15,15 @@
 #include <bpl/utils/metaprog.hpp>
 #include <bpl/utils/TaskUnit.hpp>
 #include <bpl/utils/Statistics.hpp>
+#include <bpl/utils/TimeStats.hpp>
+#include <bpl/utils/PerfCounters.hpp>
 #include <bpl/utils/splitter.hpp>
 #include <bpl/utils/split.hpp>
 #include <bpl/utils/Range.hpp>
+#include <bpl/utils/Weighted.hpp>
+#include <bpl/utils/Executor.hpp>
+#include <bpl/utils/Numa.hpp>
+#include <bpl/utils/getname.hpp>
 
 #include <vector>
 #include <array>
@@ -25,11 +31,11 @@
 #include <string>
 #include <cstring>
 #include <any>
+#include <optional>
+#include <map>
 
 #include <thread>
 
-#include <BS_thread_pool.hpp>
-
 ////////////////////////////////////////////////////////////////////////////////
 namespace bpl  {
 ////////////////////////////////////////////////////////////////////////////////
@@ -40,7 +46,9 @@ namespace bpl  {
  * a task over several threads (according to the object's initialization).
  *
  * This class also provides the number of process units it can manage. Here, a process
- * unit is a thread.
+ * unit is a thread. The threads are not owned by the instance: the jobs are run by the workers
+ * of the process-wide bpl::Executor, through a lease allowing at most 'chunksize' of them at the
+ * same time.
  *
  * It also provides some types that can be used within the execution of the task. By default in
  * this implementation, such types will be mainly std containers from the standard library.
@@ -50,10 +58,16 @@ namespace bpl  {
 class ArchMulticore : public ArchMulticoreResources
 {
 private:
-    std::unique_ptr<BS::thread_pool<>> threadpool_;
+    ExecutorLease threadpool_;
 
 public:
 
+    // The jobs are run by the workers of the process-wide executor (see LauncherPool).
+    static constexpr bool uses_executor = true;
+
+    // Several runs may be executed at the same time (see Launcher::run_async).
+    static constexpr bool concurrent_runs = true;
+
     // Factory that returns a type with a specific configuration.
     template<typename CFG=void> using factory = ArchMulticore;
 
@@ -84,38 +98,60 @@ public:
         std::size_t chunksize;
         bool trace;
         bool reset;
+        std::size_t granularity;
+        NumaMode numa;
     };
 
+    /** Create a configuration.
+     * \param taskunit : number of process units, i.e. number of parts a split argument is cut into.
+     * \param chunksize : number of threads usable at the same time.
+     * \param trace : trace mode
+     * \param reset : reset mode
+     * \param granularity : number of chunks each process unit share is over-partitioned into.
+     * The default value 1 keeps one static slice per process unit. A greater value enables a
+     * dynamic scheduling: split arguments are cut into taskunit*granularity chunks and an idle
+     * thread picks the next pending chunk, which absorbs skewed per-item costs. 'run' then returns
+     * one partial result per chunk.
+     * \param numa : placement of the split arguments on the NUMA node of the thread processing them
+     * (see bpl::NumaMode); it has no effect when the workers of the executor are not pinned.
+     * \return the configuration as a std::any object
+     */
     template<typename TASKUNIT=Thread>
     static std::any make_configuration (
         TASKUNIT taskunit  = TASKUNIT(1),
         TASKUNIT chunksize = TASKUNIT(1),
         bool trace=false,
-        bool reset=false
+        bool reset=false,
+        std::size_t granularity=1,
+        NumaMode numa=NumaMode::NONE
     )
     {
         return ArchMulticoreConfiguration {
             std::shared_ptr<TaskUnit> (new TASKUNIT(taskunit)),
-            taskunit.getNbComponents(), chunksize.getNbComponents(), trace, reset
+            taskunit.getNbComponents(), chunksize.getNbComponents(), trace, reset,
+            std::max (granularity, std::size_t(1)), numa
         };
     }
 
+    /** Constructor from a configuration built by 'make_configuration'; a std::bad_any_cast is thrown
+     * if 'config' holds something else. */
     ArchMulticore (std::any config) {
-        try {
-            auto cfg = std::any_cast<ArchMulticoreConfiguration>(config);
-            taskunit_  = cfg.taskunit;
-            nbThreads_ = cfg.nbcomponents;
-            chunkSize_ = cfg.chunksize;
-            threadpool_ = std::make_unique<BS::thread_pool<>> (std::min(nbThreads_,chunkSize_));
-        }
-        catch (const std::bad_any_cast& e)  {  std::cout << e.what() << '\n';  }
+        auto cfg = std::any_cast<ArchMulticoreConfiguration>(config);
+        taskunit_  = cfg.taskunit;
+        nbThreads_ = cfg.nbcomponents;
+        chunkSize_ = cfg.chunksize;
+        granularity_ = cfg.granularity;
+        numa_      = cfg.numa;
+        threadpool_ = Executor::instance().lease (std::min(nbThreads_,chunkSize_));
     }
 
     template<typename TASKUNIT=Thread>
     ArchMulticore (TASKUNIT taskunit = TASKUNIT(1), TASKUNIT chunksize = TASKUNIT(1),
         [[maybe_unused]] bool trace=false,
-        [[maybe_unused]] bool reset=false
-    ) : ArchMulticore (make_configuration(taskunit, chunksize, trace, reset)) {}
+        [[maybe_unused]] bool reset=false,
+        std::size_t granularity=1,
+        NumaMode numa=NumaMode::NONE
+    ) : ArchMulticore (make_configuration(taskunit, chunksize, trace, reset, granularity, numa)) {}
 
     /** Constructor.
      * \param[in] nbThreads : number of usable threads for this architecture.
@@ -137,6 +173,16 @@ public:
 
     auto getTaskUnit () const { return taskunit_; }
 
+    /** Return the number of chunks each process unit share is cut into (1 means static scheduling).
+     * \return the granularity
+     */
+    size_t getGranularity() const { return granularity_; }
+
+    /** Return the placement mode of the split arguments on the NUMA nodes.
+     * \return the NUMA mode
+     */
+    NumaMode getNumaMode() const { return numa_; }
+
     ////////////////////////////////////////////////////////////////////////////////
     /** Configure an object of type T. We distinguish here two cases:
      *   - if T is derived from Task, the we call the 'Task::configure' method
@@ -154,6 +200,19 @@ public:
 
     /** Execute a task for a given parameters pack.
      * For the multi-core architecture, we use a pool of threads.
+     *
+     * If a split argument is provided and the granularity is greater than 1, the arguments are
+     * over-partitioned into getProcUnitNumber()*granularity chunks. Each chunk is a separate job of
+     * the pool whose workers pull the next pending chunk when idle, so a thread that got cheap chunks
+     * will process more of them. The results are still returned in chunk order, which keeps
+     * the reduction deterministic. Note that there is then one result per chunk, i.e.
+     * getProcUnitNumber()*granularity results, and that the chunks of a process unit share its uid
+     * (Task::tuid) which is always lower than getProcUnitNumber().
+     *
+     * If a NUMA mode is set, the slices of the split arguments are placed on the node of the thread
+     * processing them, and the statistics report the local and remote bytes (numa/bytes/...). This
+     * needs pinned workers (see Executor): otherwise nothing is placed nor counted.
+     *
      * \param[in] args: arguments to be provided to the task.
      */
     template<template<typename ...> class TASK, typename...TRAITS, typename ...ARGS>
@@ -165,83 +224,410 @@ public:
         // Note that the TASK type is instantiated with the current ARCH type.
         using result_t = std::decay_t<bpl::return_t<decltype(&task_t::operator())>>;
 
-        // We create the result vector.
-        std::vector<result_t> results;
-
-        std::vector<float> exectimes(getProcUnitNumber());
+        // Number of jobs to be executed.
+        size_t nbitems = getNbItems<ARGS...>();
 
-        auto loop_future = threadpool_->submit_sequence <std::size_t> (0, getProcUnitNumber(),  [&] (std::size_t idx)
-        {
-            task_t task;
-
-            // We may have to configure the task, according to the fact that its class inherits (or not) from bpl:Task
-            configure (
-                task,
-                idx, // process unit uid
-                idx, // group uid: same as thread
-                0
-            );
+        RunTimes times (nbitems);
 
-            // we check whether an argument has to be split.
-            if constexpr(count_predicate_match_v<hasSplitArgument, ARGS...> == 0)
-            {
-                TimeStamp ts (exectimes[idx]);
-                return task (std::forward<decltype(args)>(args)...);
-            }
-            else
-            {
-                TimeStamp ts (exectimes[idx]);
+        numa::Counters counters;
 
-                auto config = prepare<ARGS...>(idx,getProcUnitNumber(),std::tuple<ARGS...> {std::forward<decltype(args)>(args)...});
+        TraceRun trace (bpl::type_shortname<task_t>());
 
-                // we use 'apply' here to unpack the current tuple in order to feed the 'run' method of the task.
-                return std::apply ( [&](auto &&... args)  {  return task (std::forward<decltype(args)>(args)...);  },
-                    config
-                );
-            }
+        auto loop_future = threadpool_.submit_sequence <std::size_t> (0, nbitems,  [&] (std::size_t idx)
+        {
+            TimeStamp ts (times.jobs[idx].all);
+            auto job = trace.job (idx);
+            times.setWorker (idx);
+            PerfCounters::Scope perf (times.perf[idx]);
+            return execute<TASK,TRAITS...> (idx, nbitems, counters, times.jobs[idx], std::forward<decltype(args)>(args)...);
         });
 
-        // we can do a std::move here
-        for (auto&& res : loop_future.get()) { results.push_back (std::move(res)); }
+        // The partial results are returned as a vector, in the jobs order (no copy).
+        std::vector<result_t> results = loop_future.get();
 
-        auto maxTime = *std::max_element(exectimes.begin(), exectimes.end());
-        statistics_.addTiming("run/once/launch", maxTime);
+        setStatistics (times, counters);
 
-        // We return the partial results as a vector.
         return results;
     }
 
+    /** Execute a task for a given parameters pack and provide each partial result to a sink as soon
+     * as it is available, instead of gathering all of them in a vector.
+     *
+     * The sink is called as sink(idx,result) where 'idx' is the index of the process unit (or of the chunk,
+     * see 'granularity') that produced 'result'. The calls are made from the worker threads in completion
+     * order, but never concurrently, so the sink needs no synchronization of its own. Since a result is
+     * released as soon as the sink returns, only O(threads) results are alive at the same time and the sink
+     * work (a reduction for instance) overlaps the remaining computation.
+     *
+     * \param[in] sink: callable receiving (index, result) for each process unit.
+     * \param[in] args: arguments to be provided to the task.
+     */
+    template<template<typename ...> class TASK, typename...TRAITS, typename SINK, typename ...ARGS>
+    void stream (SINK&& sink, ARGS&&...args)
+    {
+        // Number of jobs to be executed.
+        size_t nbitems = getNbItems<ARGS...>();
+
+        RunTimes times (nbitems);
+
+        std::mutex sinkMutex;
+
+        numa::Counters counters;
+
+        TraceRun trace (bpl::type_shortname<TASK<arch_t,TRAITS...>>());
+
+        threadpool_.submit_sequence <std::size_t> (0, nbitems,  [&] (std::size_t idx)
+        {
+            TimeStamp ts (times.jobs[idx].all);
+            times.setWorker (idx);
+
+            auto result = [&] ()
+            {
+                auto job = trace.job (idx);
+                PerfCounters::Scope perf (times.perf[idx]);
+                return execute<TASK,TRAITS...> (idx, nbitems, counters, times.jobs[idx], std::forward<decltype(args)>(args)...);
+            } ();
+
+            // The wait for the sink is not part of the job: the worker is idle meanwhile.
+            ts.stop();
+
+            std::lock_guard<std::mutex> lock (sinkMutex);
+            TimeStamp tsResult (times.jobs[idx].result);
+            TimeStamp tsAll    (times.jobs[idx].all);
+            sink (idx, std::move(result));
+        }).get();
+
+        setStatistics (times, counters);
+    }
+
     /** Transformation of the parameters pack according to the presence or not of a SplitProxy
      *  For each parameter:
-     *    - if it is a SplitProxy, we actually split the proxied object
-     *    - otherwise, we use the object itself without transformation.
+     *    - if it is a SplitProxy, we actually split the proxied object. If the matching parameter of the
+     *      task is a view (e.g. vector_view) and the object can provide a view on its part ('split_view'),
+     *      the part is not copied. The RAKE and RAND parts of a vector are strided views (bpl::strided_view),
+     *      passed as such to a task that accepts them and gathered in a vector otherwise.
+     *    - otherwise, the object itself is passed by reference, unless the task takes it as a non const
+     *      reference (each job then works on its own copy).
+     *  A parameter tagged with 'output' (e.g. output<span<T>>) must be fed with a split buffer: the task
+     *  gets a view on its part of the buffer and writes into it in place.
+     *  If a placer is provided, the parts of the split objects are placed on the NUMA node of the caller.
+     */
+    template<typename TASK, typename ...ARGS>
+    auto prepare (size_t idx, size_t nbitems, const std::tuple<ARGS...>& targs, numa::Placer* placer=nullptr)
+    {
+        return prepareArguments<TASK> (idx, nbitems, targs, placer, std::index_sequence_for<ARGS...>{});
+    }
+
+    /** Get statistics. The runs (see Launcher::run_async) may update them at the same time, so a copy
+     * is returned, taken under their lock.
+     * \return the statistics.
+     */
+    Statistics getStatistics() const
+    {
+        std::lock_guard<std::mutex> lock (*statisticsMutex_);
+        return statistics_;
+    }
+
+    auto resetStatistics()
+    {
+        std::lock_guard<std::mutex> lock (*statisticsMutex_);
+        statistics_={};
+    }
+
+    /** Return the lease on the executor used for running the tasks. It can also be used for reducing
+     * the partial results once 'run' is done.
+     * \return the lease
+     */
+    auto& getThreadPool() { return threadpool_; }
+
+private:
+
+    /** Number of jobs required for running a task with the given arguments types:
+     *  - one job per process unit if there is no split argument
+     *  - 'granularity' jobs per process unit otherwise.
      */
     template<typename ...ARGS>
-    decltype(auto) prepare (size_t idx, size_t nbitems, const std::tuple<ARGS...>& targs)
+    size_t getNbItems() const
+    {
+        if constexpr(count_predicate_match_v<hasSplitArgument, std::decay_t<ARGS>...> == 0)  {  return getProcUnitNumber();  }
+        else                                                                   {  return getProcUnitNumber()*granularity_;  }
+    }
+
+    /** Execute the task for one job.
+     * \param idx : index of the job
+     * \param nbitems : total number of jobs, i.e. number of parts for split arguments
+     * \param counters : NUMA placement counters of the run
+     * \param times : times of the job, where the split and exec durations are added
+     * \param args : arguments to be provided to the task.
+     * \return the result of the task
+     */
+    template<template<typename ...> class TASK, typename...TRAITS, typename ...ARGS>
+    auto execute (std::size_t idx, std::size_t nbitems, numa::Counters& counters, TimeStats& times, ARGS&&...args)
     {
-        return bpl::transform_each (targs, [&] (auto&& x)
+        using task_t = TASK<arch_t,TRAITS...>;
+
+        // The task local allocations (arena_allocator) are served by the arena of the current worker.
+        Arena::Scope arena;
+
+        task_t task;
+
+        // With a granularity greater than 1, a job is one of the chunks of a process unit: the task
+        // gets the uid of this process unit, so it stays lower than getProcUnitNumber().
+        std::size_t tuid = idx * getProcUnitNumber() / nbitems;
+
+        // We may have to configure the task, according to the fact that its class inherits (or not) from bpl:Task
+        configure (
+            task,
+            tuid, // process unit uid
+            tuid, // group uid: same as thread
+            0
+        );
+
+        // we check whether an argument has to be split.
+        if constexpr(count_predicate_match_v<hasSplitArgument, std::decay_t<ARGS>...> == 0)
         {
-            using dtype = std::decay_t<decltype(x)>;
+            TimeStamp ts (times.exec);
+            return task (std::forward<decltype(args)>(args)...);
+        }
+        else
+        {
+            // The placer (and the copies it may have done) must live during the task execution.
+            std::optional<numa::Placer> placer;
+            if (numa_ != NumaMode::NONE)  {  placer.emplace (numa_, Executor::instance().getCurrentNode(), counters);  }
 
-            if constexpr (impl::GetSplitStatus<dtype,lowest_level_t>::value > 0)
+            auto config = [&] ()
             {
-                return SplitOperator<dtype>::split (x, idx, nbitems);
-            }
-            else
+                Trace::Scope scope ("split", "multicore", -1, idx);
+                TimeStamp ts (times.split);
+                return prepare<task_t,ARGS...>(idx,nbitems,std::tuple<ARGS...> {std::forward<decltype(args)>(args)...}, placer ? &*placer : nullptr);
+            } ();
+
+            // we use 'apply' here to unpack the current tuple in order to feed the 'run' method of the task.
+            TimeStamp ts (times.exec);
+            return std::apply ( [&](auto &&... args)  {  return task (std::forward<decltype(args)>(args)...);  },
+                config
+            );
+        }
+    }
+
+    template<typename T>                 struct is_span                  : std::false_type {};
+    template<typename T, std::size_t N>  struct is_span<std::span<T,N>>  : std::true_type  {};
+
+    /** Type of the Ith parameter of a task called with N arguments (void if it can't be known). */
+    template<typename TASK, std::size_t I, std::size_t N, typename PARAMS=task_params_nodecay_t<TASK>>
+    struct task_param  {  using type = void;  };
+
+    template<typename TASK, std::size_t I, std::size_t N, typename PARAMS>
+    requires (std::tuple_size_v<PARAMS> == N)
+    struct task_param<TASK,I,N,PARAMS>  {  using type = std::tuple_element_t<I,PARAMS>;  };
+
+    template<typename TASK, std::size_t I, std::size_t N>
+    using task_param_t = typename task_param<TASK,I,N>::type;
+
+    template<typename TASK, typename ...ARGS, std::size_t...I>
+    auto prepareArguments (size_t idx, size_t nbitems, const std::tuple<ARGS...>& targs, numa::Placer* placer, std::index_sequence<I...>)
+    {
+        // NOTE: std::make_tuple turns the std::reference_wrapper items into references.
+        return std::make_tuple (prepareArgument<task_param_t<TASK,I,sizeof...(ARGS)>> (idx, nbitems, std::get<I>(targs), placer)...);
+    }
+
+    /** Transformation of one argument (see 'prepare').
+     * \param PARAM : type of the matching parameter of the task (void if unknown)
+     * \param idx : index of the job
+     * \param nbitems : total number of jobs
+     * \param x : the argument
+     * \param placer : NUMA placer (may be null)
+     * \return the argument to be provided to the task
+     */
+    template<typename PARAM, typename T>
+    auto prepareArgument (size_t idx, size_t nbitems, const T& x, numa::Placer* placer)
+    {
+        using param_t = std::decay_t<PARAM>;
+
+        if constexpr (hastag_output_v<param_t>)
+        {
+            // The task writes in place into its part of the caller buffer: we provide a view on this part,
+            // which is never placed elsewhere (a copy would not be seen by the caller).
+            static_assert (impl::GetSplitStatus<T,lowest_level_t>::value > 0 and impl::GetSplitKind<T>::value == SplitKind::CONT,
+                "an 'output' parameter requires a contiguous split argument"
+            );
+            return param_t (typename param_t::type (SplitOperator<remove_splitter_t<T>>::split_view (x, idx, nbitems)));
+        }
+        else if constexpr (impl::GetSplitStatus<T,lowest_level_t>::value > 0)
+        {
+            using type_t = remove_splitter_t<T>;
+
+            auto part = [&] ()
             {
-                return x;
-            }
-        });
+                if constexpr (impl::GetSplitKind<T>::value == SplitKind::CONT and is_span<param_t>::value and
+                    requires { { SplitOperator<type_t>::split_view (x, idx, nbitems) } -> std::convertible_to<param_t>; }
+                )
+                {
+                    return param_t (SplitOperator<type_t>::split_view (x, idx, nbitems));
+                }
+                else
+                {
+                    return SplitOperator<T>::split (x, idx, nbitems);
+                }
+            } ();
+
+            // A RAKE or RAND part is a strided view on the argument: it is gathered only if the task
+            // parameter needs contiguous items (a vector or a span for instance).
+            auto local = [&] ()
+            {
+                if constexpr (is_strided_view_v<decltype(part)> and not (std::is_void_v<PARAM> or std::is_convertible_v<decltype(part),PARAM>))
+                {
+                    return part.to_vector();
+                }
+                else  {  return std::move(part);  }
+            } ();
+
+            if (placer)  {  return placer->place (std::move(local));  }
+            return local;
+        }
+        else if constexpr (std::is_void_v<PARAM> or (std::is_lvalue_reference_v<PARAM> and not std::is_const_v<std::remove_reference_t<PARAM>>))
+        {
+            return x;
+        }
+        else
+        {
+            return std::cref (x);
+        }
     }
 
-    /** Get statistics.
-     * \return the statistics.
+    /** \brief Events of a run in the timeline (see bpl::Trace): the run itself and each of its jobs. */
+    struct TraceRun
+    {
+        TraceRun (std::string_view name) : name_(name), run_(Trace::newRun()), begin_ (run_>=0 ? timestamp_ns() : 0)  {}
+
+        ~TraceRun()
+        {
+            if (run_>=0)  {  Trace::instance().record (name_, "run", begin_, timestamp_ns(), run_);  }
+        }
+
+        /** \return the event of the job of a process unit. */
+        Trace::Scope job (std::size_t idx) const  {  return Trace::Scope ("job", "multicore", run_, idx);  }
+
+        std::string_view name_;
+        int64_t          run_;
+        uint64_t         begin_;
+    };
+
+    /** \brief Times of the jobs of a run, in nanoseconds. */
+    struct RunTimes
+    {
+        /** Worker index of a job executed by a thread that is not a worker of the executor. */
+        static constexpr std::size_t CALLER = std::size_t(-1);
+
+        RunTimes (std::size_t nbitems) : jobs(nbitems), workers(nbitems,CALLER), perf(nbitems), begin(timestamp_ns())  {}
+
+        /** Remember the worker executing a job (to be called by the job). */
+        void setWorker (std::size_t idx)  {  workers[idx] = Executor::getWorkerIndex().value_or(CALLER);  }
+
+        /** Time of each job, broken down into split, exec and result (sink call for 'stream'). */
+        std::vector<TimeStats>   jobs;
+        /** Worker that executed each job. */
+        std::vector<std::size_t> workers;
+        /** Hardware counters of each job (see PerfCounters). */
+        std::vector<PerfCounters::Values> perf;
+        /** Beginning of the run. */
+        uint64_t                 begin  = 0;
+    };
+
+    /** Report the statistics of the last run. Several runs may end at the same time (see Launcher::run_async).
+     *
+     * Besides the time of the slowest job (run/once/launch), the distribution of the jobs times is reported
+     * the same way as the tasklets times of ArchUpmem (multicore/time/min, max and quantiles), with:
+     *   - multicore/imbalance: ratio between the slowest job time and the mean job time (a tag, not a timing)
+     *   - multicore/time/split, exec and result: time spent in each phase, summed over the jobs
+     *   - multicore/time/wall: duration of the run
+     *   - multicore/idle/<worker>: time of the run during which a worker had no job of the run to execute, for
+     *     each worker that executed jobs of the run and for the calling thread ("caller"); only the last run
+     *     is reported. The other workers of the executor belong to other leases and are not reported.
+     *   - multicore/time/idle: time of the run during which the slots of the lease (see getThreadPool) had
+     *     no job of the run to execute, summed over the slots
+     *
+     * If the hardware counters are activated (see PerfCounters), their values summed over the jobs are reported
+     * as perf/cycles, perf/instructions, perf/llc-misses and perf/branch-misses tags, with perf/ipc and perf/llc-mpki
+     * (LLC misses per thousand instructions); perf/status tells whether the counters are available.
+     *
+     * \param times : times of the jobs
+     * \param counters : NUMA placement counters
      */
-    const Statistics& getStatistics() const { return statistics_; }
+    void setStatistics (const RunTimes& times, const numa::Counters& counters)
+    {
+        uint64_t wall = timestamp_ns() - times.begin;
 
-    auto resetStatistics() { statistics_={}; }
+        std::lock_guard<std::mutex> lock (*statisticsMutex_);
 
-private:
+        auto const& jobs = times.jobs;
+
+        TimeStatsValues<uint64_t> total;
+        uint64_t slowest = 0;
+        for (auto const& job : jobs)  {  total += job;  slowest = std::max (slowest, job.all);  }
+
+        statistics_.addTiming("run/once/launch", slowest * 1e-9);
+        statistics_.set      ("run/chunks", jobs.size());
+
+        // Each job measured its own duration -> we gather them in the histogram of the jobs.
+        static const Statistics::Phase jobsPhase ("run", "job");
+        for (auto const& job : jobs)  {  statistics_.record (jobsPhase, job.all);  }
+
+        addTimeStatsTags (statistics_, "multicore/time", jobs, 1e9);
+
+        double mean = jobs.empty() ? 0.0 : double(total.all) / jobs.size();
+        char imbalance[32];
+        snprintf (imbalance, sizeof(imbalance), "%.3f", mean>0 ? slowest/mean : 1.0);
+        statistics_.addTag ("multicore/imbalance", imbalance);
+        statistics_.addTiming ("multicore/time/split",  total.split  * 1e-9);
+        statistics_.addTiming ("multicore/time/exec",   total.exec   * 1e-9);
+        statistics_.addTiming ("multicore/time/result", total.result * 1e-9);
+        statistics_.addTiming ("multicore/time/wall",   wall * 1e-9);
+
+        // A worker is idle during the part of the run not spent in its own jobs. Only the workers of the
+        // run are reported: the workers of a previous run are removed first, since they may differ.
+        std::map<std::size_t,uint64_t> busy;
+        for (std::size_t i=0; i<jobs.size(); i++)  {  busy[times.workers[i]] += jobs[i].all;  }
+
+        uint64_t slots = threadpool_.get_thread_count() * wall;
+        statistics_.addTiming ("multicore/time/idle", (slots>total.all ? slots-total.all : 0) * 1e-9);
+
+        statistics_.removeTimings ("multicore/idle/");
+
+        auto setIdle = [&] (std::size_t worker, const std::string& name)
+        {
+            auto     lookup   = busy.find (worker);
+            uint64_t duration = lookup != busy.end() ? lookup->second : 0;
+            statistics_.addTiming ("multicore/idle/" + name, (wall>duration ? wall-duration : 0) * 1e-9);
+        };
+
+        for (auto [worker,duration] : busy)  {  if (worker != RunTimes::CALLER)  {  setIdle (worker, std::to_string(worker));  }  }
+        setIdle (RunTimes::CALLER, "caller");
+
+        if (PerfCounters::enabled())
+        {
+            PerfCounters::Values perf;
+            for (auto const& values : times.perf)  {  perf += values;  }
+
+            statistics_.addTag ("perf/status", PerfCounters::getStatus());
+            if (PerfCounters::active())
+            {
+                char buffer[32];
+                for (std::size_t e=0; e<PerfCounters::NB_EVENTS; e++)
+                {
+                    statistics_.addTag (std::string("perf/") + PerfCounters::names[e], std::to_string (perf.counts[e]));
+                }
+                snprintf (buffer, sizeof(buffer), "%.3f", perf.getIPC());   statistics_.addTag ("perf/ipc",      buffer);
+                snprintf (buffer, sizeof(buffer), "%.3f", perf.getMPKI());  statistics_.addTag ("perf/llc-mpki", buffer);
+            }
+        }
+
+        if (numa_ == NumaMode::NONE)  { return; }
+        statistics_.set ("numa/bytes/local",    counters.local);
+        statistics_.set ("numa/bytes/remote",   counters.remote);
+        statistics_.set ("numa/bytes/copied",   counters.copied);
+        statistics_.set ("numa/bytes/migrated", counters.migrated);
+    }
 
     std::shared_ptr<TaskUnit> taskunit_;
 
@@ -251,7 +637,16 @@ private:
     /** Number of threads usable at the same time. */
     size_t chunkSize_ = 1;
 
+    /** Number of chunks per process unit for split arguments (1 means static scheduling). */
+    size_t granularity_ = 1;
+
+    /** Placement of the split arguments on the NUMA nodes. */
+    NumaMode numa_ = NumaMode::NONE;
+
     Statistics statistics_;
+
+    /** Shared by the copies of the object, which keeps it copyable. */
+    std::shared_ptr<std::mutex> statisticsMutex_ = std::make_shared<std::mutex>();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -16,11 +16,16 @@
 #include <mutex>
 
 #include <bpl/utils/tag.hpp>
+#include <bpl/utils/Arena.hpp>
+#include <bpl/utils/Sharded.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace bpl  {
 ////////////////////////////////////////////////////////////////////////////////
 
+/** \brief A tagged span (e.g. global<vector_view<T>>) is built from a vector argument, so it is kept by value. */
+template<typename T, std::size_t N>  struct tag_by_value<std::span<T,N>> : std::true_type {};
+
 /** \brief Defines the alias types needed for the ARCH macro.
  */
 struct ArchMulticoreResources
@@ -38,10 +43,14 @@ struct ArchMulticoreResources
 
     template<typename T>        using span   = std::span<T>;
 
-    template<typename T>        using vector_view = std::vector<T>;
+    // A vector view is a non owning view, so split and unsplit vector arguments are not copied.
+    template<typename T>        using vector_view = std::span<const T>;
 
     template<typename T>        using allocator = std:: allocator<T>;
 
+    // Allocator for the task local containers: served by the arena of the worker thread (see bpl::Arena).
+    template<typename T>        using arena_allocator = ArenaAllocator<T>;
+
     template<typename T>        using initializer_list = std::initializer_list<T>;
 
     template<typename ...Ts>    using tuple  = std::tuple<Ts...>;
@@ -75,6 +84,12 @@ struct ArchMulticoreResources
 
     template<typename T> using once   = bpl::once<T>;
     template<typename T> using global = bpl::global<T>;
+    template<typename T> using output = bpl::output<T>;
+
+    // Accumulators updated by several process units without lock (see bpl::Sharded).
+    template<typename T, typename...OP>      using sharded   = bpl::Sharded<T,OP...>;
+    template<typename T>                     using counter   = bpl::Counter<T>;
+    template<std::size_t N, typename...T>    using histogram = bpl::Histogram<N,T...>;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
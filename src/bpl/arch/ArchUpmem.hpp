@@ -11,6 +11,7 @@
 #include <string>
 #include <array>
 #include <map>
+#include <list>
 #include <sstream>
 #include <memory>
 #include <numeric>
@@ -27,6 +28,7 @@
 #include <bpl/utils/FileUtils.hpp>
 #include <bpl/utils/TimeUtils.hpp>
 #include <bpl/utils/splitter.hpp>
+#include <bpl/utils/StridedView.hpp>
 #include <bpl/utils/Statistics.hpp>
 #include <config.hpp>
 #include <filesystem>
@@ -61,6 +63,12 @@ enum DpuComponentKind_e {
  */
 template<typename ARG, typename PARAM> struct check_arguments: std::true_type {};
 
+// A parameter tagged with 'output' is not supported yet: the results of the tasklets are only retrieved
+// through 'result_wrapper'.
+template<typename ARG, typename PARAM>
+requires (bpl::hastag_output_v<std::decay_t<PARAM>>)
+struct check_arguments<ARG,PARAM> : std::false_type {};
+
 ///////////////////////////////////////////////////////////////////////////////
 class ArchUpmem;
 
@@ -188,7 +196,7 @@ public:
             auto cfg = std::any_cast < ArchUpmemConfiguration > (config);
             taskunit_ = cfg.taskunit;
 
-            auto ts = statistics_.produceCumulTimestamp("init", "alloc");
+            auto ts = statistics_.timer<"init","alloc">();
 
             dpuSet_ = std::make_shared < impl::dpu_set_handle_t> (cfg.kind, cfg.nbcomponents, nullptr, cfg.trace);
 
@@ -272,12 +280,12 @@ public:
 
         // Being here means that the input parameters should have already been broadcasted to the DPUs.
 
-        auto ts = statistics_.produceCumulTimestamp("run", "all");
+        auto ts = statistics_.timer<"run","all">();
 
         DEBUG_ARCH_UPMEM ("[ArchUpmem::run]  BEGIN\n");
 
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    auto ts_pre_launch = statistics_.produceCumulTimestamp("run", "pre");
+    auto ts_pre_launch = statistics_.timer<"run","pre">();
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
         // We determine the result type of the TASK::run method.
@@ -294,10 +302,11 @@ public:
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    auto ts_launch = statistics_.produceCumulTimestamp("run", "launch");
+    auto ts_launch = statistics_.timer<"run","launch">();
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
         // We launch the execution.
+        uint64_t launchBegin = timestamp_ns();
         DPU_ASSERT(dpu_launch(set(), DPU_SYNCHRONOUS));
 
     //----------------------------------------------------------------------
@@ -307,7 +316,7 @@ public:
         statistics_.increment ("dpu_launch");
 
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    auto ts_post_launch = statistics_.produceCumulTimestamp("run", "post");
+    auto ts_post_launch = statistics_.timer<"run","post">();
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
         DEBUG_ARCH_UPMEM ("[ArchUpmem::run]  dpu_launch done\n");
@@ -360,6 +369,8 @@ public:
 
         } // end of for (const MetadataOutput& metadata : __metadata_output__)
 
+        if (Trace::enabled())  {  traceTasklets (launchBegin);  }
+
         if (useStats_)
         {
             // We retrieve optional information used for statistics
@@ -417,7 +428,7 @@ public:
     //----------------------------------------------------------------------
 
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    auto ts_final_result = statistics_.produceCumulTimestamp("run", "result");
+    auto ts_final_result = statistics_.timer<"run","result">();
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
         constexpr bool VECTOR_SERIALIZE_OPTIM = get_VECTOR_SERIALIZE_OPTIM_v<typename task_t::traits_t,false>;
@@ -453,7 +464,7 @@ public:
     template<template<typename ...> class TASK, typename...TRAITS, typename ...ARGS>
     auto prepare (ARGS&&... args)
     {
-        volatile auto ts_all = statistics_.produceCumulTimestamp("prepare","all");
+        volatile auto ts_all = statistics_.timer<"prepare","all">();
 
         using task_t = TASK<arch_t,TRAITS...>;
 
@@ -490,12 +501,18 @@ public:
         [[maybe_unused]] bool alreadyLoaded = false;
 
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    auto ts_serialize1 = statistics_.produceCumulTimestamp("prepare", "serialize(size)");
+    auto ts_serialize1 = statistics_.timer<"prepare","serialize(size)">();
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
         uint8_t splitStatus[32];
         retrieveSplitStatus<lowest_level_t,ARGS...>(splitStatus);
 
+        uint8_t splitKind[32];
+        retrieveSplitKind<ARGS...>(splitKind);
+
+        uint32_t splitSeed[32];
+        retrieveSplitSeed (targs, splitSeed);
+
         // We have to check that provided ARGS arguments are compatible with the task parameters
         // in case we want to split one of argument.
         // For instance, we can not split a vector if the underlying parameter is a tagged with 'global'
@@ -509,7 +526,7 @@ public:
     //----------------------------------------------------------------------
 
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    auto ts_serialize2 = statistics_.produceCumulTimestamp("prepare","serialize(buffer)");
+    auto ts_serialize2 = statistics_.timer<"prepare","serialize(buffer)">();
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
         // NOTE: we may have to serialize ONLY a part of the arguments. For instance, if some are references and a previous call has been made,
@@ -546,6 +563,12 @@ public:
         // We need a vehicle to provide information for broadcast through scatter/gather API.
         offset_matrix_t offsets (dpuSet_->getDpuNumber());
 
+        // RAKE and RAND split parts are not contiguous in host memory while the scatter/gather API needs
+        // contiguous blocks: each part (a strided view) is gathered once in a vector that must live until
+        // the broadcast. The DPUs of a rank receiving the same part (split at rank level) share this copy.
+        // For each argument, the parts are indexed by their partition index.
+        std::list<std::map<size_t,std::shared_ptr<void>>> splitParts;
+
         // This implementation will return an iterable over the arguments (potentially split)
         // NOTE: the previous implementation returned a vector (was more memory consuming)
         auto transfo = [&] (size_t argIdx, auto&& arg)
@@ -575,6 +598,7 @@ public:
                 size_t div_;
                 size_t idx_;
                 size_t nb_;
+                std::map<size_t,std::shared_ptr<void>>* parts_;
 
                 bool operator!= (const iterator & other) const { return idx_ != other.idx_; }
 
@@ -586,7 +610,25 @@ public:
                     size_t idx   = idx_/div_;
                     size_t total = (nb_+div_-1)/div_;
 
-                    return SplitChoice<decltype(arg_),result_t,task_t>::split_view (arg_,idx,total);
+                    if constexpr (impl::GetSplitKind<dtype>::value == SplitKind::CONT)
+                    {
+                        return SplitChoice<decltype(arg_),result_t,task_t>::split_view (arg_,idx,total);
+                    }
+                    else
+                    {
+                        auto gather = [&] ()
+                        {
+                            auto part = split_kind<impl::GetSplitKind<dtype>::value> ((const result_t&)arg_, idx, total, arg_.seed_);
+                            if constexpr (is_strided_view_v<decltype(part)>)  {  return part.to_vector();  }
+                            else                                              {  return part;              }
+                        };
+
+                        using part_t = decltype(gather());
+
+                        auto& part = (*parts_)[idx];
+                        if (not part)  {  part = std::make_shared<part_t> (gather());  }
+                        return *std::static_pointer_cast<part_t> (part);
+                    }
                 }
             };
 
@@ -595,16 +637,17 @@ public:
                 dtype&  arg_;   // we get a reference on the argument (no copy then)
                 size_t div_;
                 size_t nb_;
+                std::map<size_t,std::shared_ptr<void>>* parts_;
 
-                auto begin() const  { return iterator {arg_, div_,  0, nb_}; }
-                auto end()   const  { return iterator {arg_, div_,nb_, nb_}; }
+                auto begin() const  { return iterator {arg_, div_,  0, nb_, parts_}; }
+                auto end()   const  { return iterator {arg_, div_,nb_, nb_, parts_}; }
             };
 
             size_t div = splitStatus[argIdx] == Rank::LEVEL ?
                 64 :  // split at rank level: each DPU of the same rank will receive the same data.
                 1;    // split at DPU  level: each DPU will receive a specific data.
 
-            return iterable_wrapper { (dtype&)arg, div, dpuSet_->getDpuNumber()};
+            return iterable_wrapper { (dtype&)arg, div, dpuSet_->getDpuNumber(), &splitParts.emplace_back()};
 
         }; // end of auto transfo = []
 
@@ -673,7 +716,8 @@ public:
         size_t broadcastSize = 0;
 
         // We create the serialization buffer.
-        if (isLoadedBinaryMatching and hasTagOnce)
+        // A binary loaded by 'preload' doesn't have the 'once' arguments yet.
+        if (isLoadedBinaryMatching and hasTagOnce and not preloaded_)
         {
             // We get rid of the first arguments that are tagged with 'once'
             auto targsSliced = bpl::tuple_slice <firstNoTagOnceRefIdx, sizeof...(ARGS)>(targs);
@@ -704,6 +748,8 @@ public:
             deltaFirstNotagOnce = 0;
         }
 
+        preloaded_ = false;
+
         // We want to compute the max size of serialization for all the DPU.
         size_t maxSumSizeDpu=0;
         for (auto s : sumSizePerDpu)  { if (s>maxSumSizeDpu) { maxSumSizeDpu=s; } }
@@ -731,28 +777,14 @@ public:
     //----------------------------------------------------------------------
 
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    auto ts_loadbinary = statistics_.produceCumulTimestamp("prepare", "loadBinary");
+    auto ts_loadbinary = statistics_.timer<"prepare","loadBinary">();
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
         // We load the binary on the DPUs if needed, according to the task name and the size of __args__ buffer.
 
         if (not isLoadedBinaryMatching)
         {
-            // Tuple holding the types tagged with 'global'  (we remove tags now)
-            using globalparams_t = bpl::transform_tuple_t <
-                typename bpl::pack_predicate_partition_t <
-                    bpl::hastag_global,
-                    bpl::task_params_t<task_t>
-                >::first_type,
-                bpl::removetag_once,
-                bpl::removetag_global
-            >;
-
-            static constexpr int sizeofGlobal = bpl::sum_sizeof (globalparams_t{});
-            static_assert (sizeofGlobal < 65536);
-
-            // We compute the % of WRAM available for tasklets (round down to a decade)
-            static constexpr int wramGlobalPercent       = int ( (100.0*sizeofGlobal)/65536);
+            static constexpr int wramGlobalPercent = getWramGlobalPercent<task_t>();
 
             // We use the name of the type thanks to some MPL magic -> no more need to define a 'name' function in the task structure.
             alreadyLoaded = loadBinary (bpl::type_shortname<TASK<arch_t>>(), 'A', maxSumSizeDpu, wramGlobalPercent);
@@ -767,7 +799,7 @@ public:
     //----------------------------------------------------------------------
 
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    auto ts_broadcast1 = statistics_.produceCumulTimestamp("prepare","broadcast(1)");
+    auto ts_broadcast1 = statistics_.timer<"prepare","broadcast(1)">();
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
         struct data_t
@@ -861,7 +893,7 @@ public:
     //----------------------------------------------------------------------
 
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    auto ts_broadcast2 = statistics_.produceCumulTimestamp("prepare", "broadcast(2)");
+    auto ts_broadcast2 = statistics_.timer<"prepare","broadcast(2)">();
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
         // We prepare a vector holding the input metadata for all DPU.
@@ -875,7 +907,9 @@ public:
                 deltaFirstNotagOnce,
                 reset_,
                 oncePaddingPerDpu_.empty() ? 0 : oncePaddingPerDpu_[dpuIdx],
-                splitStatus
+                splitStatus,
+                splitKind,
+                splitSeed
             );
         }
 
@@ -897,10 +931,32 @@ public:
         DEBUG_ARCH_UPMEM ("[ArchUpmem::prepare]  END\n");
     }
 
+    /** Load the binary of a task on the DPUs without running it, so that the first 'run' of the task
+     * doesn't pay for the loading.
+     */
+    template<template<typename ...> class TASK, typename...TRAITS>
+    void preload ()
+    {
+        auto ts = statistics_.timer<"prepare","loadBinary">();
+
+        if (not previousBinary_.match (bpl::type_shortname<TASK<arch_t>>(), 'A'))
+        {
+            loadBinary (bpl::type_shortname<TASK<arch_t>>(), 'A', 0, getWramGlobalPercent<TASK<arch_t,TRAITS...>>());
+            preloaded_ = true;
+        }
+    }
+
     const bpl::Statistics& getStatistics() const { return statistics_; }
 
     auto resetStatistics() { statistics_={}; }
 
+#ifdef WITH_THREADPOOL
+    /** Return the host thread pool, usable for instance for reducing the partial results.
+     * \return the thread pool
+     */
+    auto& getThreadPool() { return *threadpool_; }
+#endif
+
 private:
     std::shared_ptr<TaskUnit> taskunit_;
 
@@ -948,6 +1004,30 @@ private:
     std::unique_ptr<BS::thread_pool<>> threadpool_;
 #endif
 
+    /** \return the % of WRAM used by the 'global' parameters of a task, the tasklets stacks getting the remaining. */
+    template<typename task_t>
+    static constexpr int getWramGlobalPercent()
+    {
+        // Tuple holding the types tagged with 'global'  (we remove tags now)
+        using globalparams_t = bpl::transform_tuple_t <
+            typename bpl::pack_predicate_partition_t <
+                bpl::hastag_global,
+                bpl::task_params_t<task_t>
+            >::first_type,
+            bpl::removetag_once,
+            bpl::removetag_global
+        >;
+
+        constexpr int sizeofGlobal = bpl::sum_sizeof (globalparams_t{});
+        static_assert (sizeofGlobal < 65536);
+
+        // We compute the % of WRAM available for tasklets (round down to a decade)
+        return int ( (100.0*sizeofGlobal)/65536);
+    }
+
+    /** Tells that the current binary was loaded by 'preload' and didn't receive any argument yet. */
+    bool preloaded_ = false;
+
     /** \brief Load a binary into the DPUs
      * \param[in] name : name of the binary
      * \param[in] type : type of the binary
@@ -1061,47 +1141,42 @@ private:
         throw std::runtime_error(std::string{"no found binary for taskname "} + std::string{taskname});
     }
 
-    void computeCyclesStats (const std::vector<TimeStats>& nbCycles, uint32_t clocks_per_sec)
+    /** Add the phases of each tasklet of the last run to the timeline (see bpl::Trace). The DPUs only provide
+     * the number of cycles of each phase, so the phases are laid out one after the other from the launch.
+     * \param[in] launchBegin : timestamp of the launch
+     */
+    void traceTasklets (uint64_t launchBegin)
     {
-        char buffer[512];
-
-        auto [min,max,quantiles] = TimeStats::minmax (nbCycles);
-
-        statistics_.addTag ("dpu/clock", std::to_string(clocks_per_sec));
+        int64_t run = Trace::newRun();
 
-        auto dump = [&] (const std::string& prefix, auto value)
+        for (size_t d=0; d<__metadata_output__.size(); d++)
         {
-            double all = value.unserialize + value.split + value.exec + value.result;
-
-            snprintf (buffer, sizeof(buffer), "time: %.4f sec  (%.4f + %.4f + %.4f + %.4f)  [percent]  unserialize: %5.2f   split: %5.2f  exec:%5.2f  result: %5.2f",
-                // double(value.all) / clocks_per_sec,
-                double(all)               / clocks_per_sec,
-                double(value.unserialize) / clocks_per_sec,
-                double(value.split)       / clocks_per_sec,
-                double(value.exec)        / clocks_per_sec,
-                double(value.result)      / clocks_per_sec,
-                100.0*value.unserialize   / all,
-                100.0*value.split         / all,
-                100.0*value.exec          / all,
-                100.0*value.result        / all
-            );
-            statistics_.addTag (prefix,buffer);
-        };
+            auto const& metadata = __metadata_output__[d];
+            double nsPerCycle = metadata.clocks_per_sec>0 ? 1e9 / metadata.clocks_per_sec : 0.0;
 
-        dump ("dpu/time/max", max);
-        dump ("dpu/time/min", min);
+            for (size_t t=0; t<NR_TASKLETS; t++)
+            {
+                auto const& c = metadata.nb_cycles[t];
 
-        std::stringstream ss;
-        snprintf (buffer, sizeof(buffer), "[%2ld]", nbCycles.size());
-        ss << buffer;
+                using phase_t = std::pair<const char*,uint64_t>;
 
-        for (auto x : quantiles)
-        {
-            snprintf (buffer, sizeof(buffer), " %.3f", (double)x / clocks_per_sec);
-            ss << buffer;
+                uint64_t begin = launchBegin;
+                uint64_t tid   = d*NR_TASKLETS + t;
+                for (auto [name,cycles] : { phase_t {"unserialize",c.unserialize}, phase_t {"split",c.split}, phase_t {"exec",c.exec}, phase_t {"result",c.result} })
+                {
+                    uint64_t end = begin + uint64_t (cycles*nsPerCycle);
+                    Trace::instance().record (Trace::Event { name, "dpu", begin, end, Trace::DPU, tid, run, int64_t(tid) });
+                    begin = end;
+                }
+            }
         }
+    }
+
+    void computeCyclesStats (const std::vector<TimeStats>& nbCycles, uint32_t clocks_per_sec)
+    {
+        statistics_.addTag ("dpu/clock", std::to_string(clocks_per_sec));
 
-        statistics_.addTag ("dpu/time/quantiles", ss.str());
+        addTimeStatsTags (statistics_, "dpu/time", nbCycles, clocks_per_sec);
     }
 
     // Return rank info (ptr and DPU number) of the given set.
@@ -8,8 +8,7 @@
 
 #include <firstinclude.hpp>
 #include <vector>
-
-#define WITH_STATS_TIME_MEDIAN 1
+#include <bpl/utils/TimeStats.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace bpl  {
@@ -22,91 +21,6 @@ namespace bpl  {
 // will be sent to the host and will be available through the calling launcher.
 ////////////////////////////////////////////////////////////////////////////////
 
-/** \brief Generic class that gathers time information during a tasklet execution.
- */
-template<typename T>
-struct TimeStatsValues
-{
-    /** Total time of the tasklet. */
-    T all         = T();
-    /** Time taken by a tasklet for the unserialization of the incoming arguments from the host. */
-    T unserialize = T();
-    /** Time taken by a tasklet for splitting the arguments encapsulated by a call to 'split' at host call site. */
-    T split       = T();
-    /** Time taken by a tasklet for the running the task, ie. call to operator(). */
-    T exec        = T();
-    /** Time taken by a tasklet for preparing the result for the host. */
-    T result      = T();
-
-    /** Increase the fields values of the current object with the fields values of an input object. */
-    template<typename T1>
-    TimeStatsValues<T>& operator+= (const TimeStatsValues<T1>& o)
-    {
-        all         += o.all;
-        unserialize += o.unserialize;
-        split       += o.split;
-        exec        += o.exec;
-        result      += o.result;
-        return *this;
-    }
-};
-
-/** \brief Class that gathers time information during a tasklet execution.
- *
- * Uses a specific type for gathering the information.
- * \see TimeStatsValues
- */
-struct TimeStats : TimeStatsValues<uint64_t>
-{
-    using value_type = uint64_t;
-
-    static auto minmax (const std::vector<TimeStats>& entries)
-    {
-        TimeStats m;
-        TimeStats M;
-
-        m.all = std::numeric_limits<value_type>::max();
-        M.all = 0;
-
-        std::vector<value_type> alls;
-        for (const auto& x : entries)
-        {
-            alls.push_back (x.all);
-            if (x.all < m.all)  { m = x; }
-            if (x.all > M.all)  { M = x; }
-        }
-
-#ifdef WITH_STATS_TIME_MEDIAN
-        std::sort(alls.begin(), alls.end());
-#endif
-        std::array<value_type,32> quantiles = {};
-
-        if (not alls.empty())
-        {
-            size_t idx=0; for (auto& x : quantiles) { x = alls[idx*alls.size()/quantiles.size()]; idx++; }
-            quantiles.back() = alls.back();
-        }
-
-        return std::make_tuple (m,M,quantiles);
-    }
-
-    static auto mean (const std::vector<TimeStats>& entries)
-    {
-        TimeStatsValues<uint64_t> res;
-
-        for (const auto& x : entries)  {  res += x;  }
-
-        return TimeStatsValues<double>
-        {
-            double(res.unserialize) / double(res.all),
-            double(res.split)       / double(res.all),
-            double(res.exec)        / double(res.all),
-            double(res.result)      / double(res.all),
-            double(res.all)         / double(entries.size())
-        };
-    }
-};
-
 /** \brief provides information about memory allocations (notably for the MRAM)
  */
 struct AllocatorStats
@@ -131,12 +45,14 @@ struct MetadataInput
     /** Maximum number of parameters allowed in the prototype of a task (should be better defined at another location). */
     static constexpr int ARGS_MAX_NUMBER = 32;
 
-    MetadataInput ()  {  for (size_t i=0; i<ARGS_MAX_NUMBER; i++)  {  argsSplitStatus[i] = 0; }  }
+    MetadataInput ()  {  for (size_t i=0; i<ARGS_MAX_NUMBER; i++)  {  argsSplitStatus[i] = 0;  argsSplitKind[i] = 0;  argsSplitSeed[i] = 0; }  }
 
-    MetadataInput (uint32_t nbtaskunits, uint32_t dpuid, uint32_t bufferSize, uint32_t deltaOnce, uint32_t reset, uint32_t oncePadding, uint8_t splitStatus[ARGS_MAX_NUMBER])
+    MetadataInput (uint32_t nbtaskunits, uint32_t dpuid, uint32_t bufferSize, uint32_t deltaOnce, uint32_t reset, uint32_t oncePadding,
+        uint8_t splitStatus[ARGS_MAX_NUMBER], uint8_t splitKind[ARGS_MAX_NUMBER], uint32_t splitSeed[ARGS_MAX_NUMBER]
+    )
     :   nbtaskunits(nbtaskunits), dpuid(dpuid), bufferSize(bufferSize), deltaOnce(deltaOnce), reset(reset), oncePadding(oncePadding)
     {
-        for (size_t i=0; i<ARGS_MAX_NUMBER; i++)  {  argsSplitStatus[i] = splitStatus[i]; }
+        for (size_t i=0; i<ARGS_MAX_NUMBER; i++)  {  argsSplitStatus[i] = splitStatus[i];  argsSplitKind[i] = splitKind[i];  argsSplitSeed[i] = splitSeed[i]; }
     }
 
     /** Not used. */
@@ -153,6 +69,10 @@ struct MetadataInput
     uint32_t oncePadding = 0;
     /** Gives the split status for the arguments of the task. */
     uint8_t  argsSplitStatus[ARGS_MAX_NUMBER];
+    /** Gives the split kind (see bpl::SplitKind) for the arguments of the task. */
+    uint8_t  argsSplitKind  [ARGS_MAX_NUMBER];
+    /** Gives the seed of the RAND split for the arguments of the task. */
+    uint32_t argsSplitSeed  [ARGS_MAX_NUMBER];
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -19,6 +19,7 @@
 #include <bpl/utils/BufferIterator.hpp>
 #include <bpl/utils/vector.hpp>
 #include <bpl/utils/tag.hpp>
+#include <bpl/utils/Sharded.hpp>
 #include <bpl/arch/dpu/ArchUpmemMRAM.hpp>
 #include <bpl/utils/tag.hpp>
 
@@ -29,6 +30,8 @@
 
 extern bpl::MRAM::Allocator<true>  __MRAM_Allocator_lock__;
 
+extern const mutex_id_t  __Counter_mutex__;
+
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace bpl  {
@@ -239,6 +242,9 @@ struct ArchUpmemResources
         static const int MEMTREE_MAX_MEMORY_LOG2         = constants_t::MEMTREE_MAX_MEMORY_LOG2;
     };
 
+    // The MRAM allocator is already a bump allocator, reset between two runs.
+    template<typename T>  using arena_allocator = allocator<T>;
+
     template<
         typename T,
         typename Allocator = allocator<T>,
@@ -298,6 +304,67 @@ struct ArchUpmemResources
 
     template<typename T> using once   = bpl::once<T>;
     template<typename T> using global = bpl::global<T>;
+    template<typename T> using output = bpl::output<T>;
+
+    // Accumulators updated by the tasklets without lock: each tasklet has its own slot and the slots
+    // are combined when the value is needed.
+    template<typename T, typename OP=bpl::AddOp<T>>
+    struct sharded
+    {
+        template<typename U>
+        void add (const U& x)  {  slots_[me()] = OP() (slots_[me()], x);  }
+
+        T value() const
+        {
+            T result = slots_[0];
+            for (int i=1; i<NR_TASKLETS; i++)  {  result = OP() (result, slots_[i]);  }
+            return result;
+        }
+
+        void reset()  {  for (int i=0; i<NR_TASKLETS; i++)  {  slots_[i] = T{};  }  }
+
+        T slots_[NR_TASKLETS] = {};
+    };
+
+    // The DPU has no atomic addition, so the counters are protected by a hardware mutex (shared by
+    // all the counters, see __Counter_mutex__); its cost is small compared to a MRAM access.
+    template<typename T>
+    struct counter
+    {
+        T fetch_add (T n=1)
+        {
+            mutex_lock (__Counter_mutex__);
+            T previous = value_;
+            value_ += n;
+            mutex_unlock (__Counter_mutex__);
+            return previous;
+        }
+
+        void add (T n=1)  {  fetch_add (n);  }
+
+        T value() const  {  return value_;  }
+
+        void reset()  {  value_ = T{};  }
+
+        T value_ = T{};
+    };
+
+    template<std::size_t N, typename T=uint64_t>
+    struct histogram
+    {
+        void add (std::size_t bin, T n=1)  {  bins_[me()][bin] += n;  }
+
+        T operator[] (std::size_t bin) const
+        {
+            T result = 0;
+            for (int i=0; i<NR_TASKLETS; i++)  {  result += bins_[i][bin];  }
+            return result;
+        }
+
+        void reset()  {  for (int i=0; i<NR_TASKLETS; i++)  { for (std::size_t j=0; j<N; j++)  {  bins_[i][j] = 0;  } }  }
+
+        T bins_[NR_TASKLETS][N] = {};
+    };
 
     struct mutex
     {
@@ -818,6 +885,42 @@ struct SplitOperator<bpl::vector<T,bpl::VectorAllocator,MUTEX,MEMORY_SIZE_LOG2,C
 
         return result;
     }
+
+    // RAKE split: the items are not contiguous in MRAM, so we have to iterate the vector and copy the selected items.
+    static auto split_rake (const bpl::vector<T,bpl::VectorAllocator,MUTEX,MEMORY_SIZE_LOG2,CACHE_NB_LOG2,SHARED_ITER_CACHE,MEMTREE_NBITEMS_PER_BLOCK_LOG2,MAX_MEMORY_LOG2>& x, std::size_t idx, std::size_t total)
+    {
+        return gather (x, [&] (std::size_t i)  {  return i%total == idx;  });
+    }
+
+    // RAND split: we need the position of each item in the permutation (see impl::SplitPermutation).
+    static auto split_rand (const bpl::vector<T,bpl::VectorAllocator,MUTEX,MEMORY_SIZE_LOG2,CACHE_NB_LOG2,SHARED_ITER_CACHE,MEMTREE_NBITEMS_PER_BLOCK_LOG2,MAX_MEMORY_LOG2>& x, std::size_t idx, std::size_t total, uint32_t seed=0)
+    {
+        std::size_t p0 = x.size() * (idx+0) / total;
+        std::size_t p1 = x.size() * (idx+1) / total;
+
+        impl::SplitPermutation perm (x.size(), seed);
+
+        return gather (x, [&] (std::size_t i)  {  auto p = perm.inverse(i);  return p0<=p and p<p1;  });
+    }
+
+private:
+
+    template<typename VECTOR, typename FCT>
+    static auto gather (const VECTOR& x, FCT select)
+    {
+        VECTOR result;
+
+        std::size_t i=0;
+        for (const auto& item : (VECTOR&) x)
+        {
+            if (select(i))  { result.push_back (item); }
+            i++;
+        }
+
+        result.flush();
+
+        return result;
+    }
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <bpl/bank/Sequence.hpp>
+#include <bpl/bank/PackedSequence.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace bpl  {
@@ -29,8 +30,9 @@ namespace bpl  {
  * but it is important when this class is used in a UPMEM context.
  * \param SEQSIZE: number of characters for a sequence.
  * \param SEQNB: number of sequences in the bank.
+ * \param SEQUENCE: type of the sequences, for instance PackedSequence<SEQSIZE> for 2 bits nucleotides.
  */
-template<class ARCH, int SEQSIZE=32, int SEQNB=64>
+template<class ARCH, int SEQSIZE=32, int SEQNB=64, typename SEQUENCE=Sequence<SEQSIZE>>
 class BankChunk
 {
 public:
@@ -49,6 +51,7 @@ public:
      * \param generator: the sequences generator.
      */
     template<typename GENERATOR>
+    requires (not std::is_same_v<std::decay_t<GENERATOR>,BankChunk>)
     BankChunk (GENERATOR generator)
     {
         auto outBegin = this->begin();
@@ -84,13 +87,13 @@ public:
     /** Number of sequences in the bank. */
     size_t size() const { return sequences_.size();  }
 
-    array<Sequence<SEQSIZE>,SEQNB> sequences_;
+    array<SEQUENCE,SEQNB> sequences_;
 };
 
 /** \brief Template specialization for BankChunk.
  */
-template<typename ARCHI, int SEQSIZE, int SEQNB>
-struct serializable<bpl::BankChunk<ARCHI,SEQSIZE,SEQNB>>
+template<typename ARCHI, int SEQSIZE, int SEQNB, typename SEQUENCE>
+struct serializable<bpl::BankChunk<ARCHI,SEQSIZE,SEQNB,SEQUENCE>>
 {
     // we tell that our structure can be serialized
     static constexpr int value = true;
@@ -9,42 +9,381 @@
 #pragma once
 
 #include <string>
-#include <bpl/bank/Sequence.hpp>
+#include <string_view>
+#include <memory>
+#include <stdexcept>
+#include <cstring>
+#include <bpl/utils/splitter.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace bpl  {
 ////////////////////////////////////////////////////////////////////////////////
 
-/** \brief Not used. */
-template<class ARCH, int SEQSIZE=32>
-class BankFasta
+/** \brief Record of a FASTA/FASTQ bank.
+ *
+ * The fields are views on the bank content (or on a buffer of the iterator for multi-lines FASTA
+ * sequences), so they are valid only until the iterator is incremented.
+ */
+struct SequenceRecord
 {
-    struct iterator;
+    /** Header of the record without the leading '>' or '@'. */
+    std::string_view id;
+
+    /** Nucleotides of the record. */
+    std::string_view data;
+
+    /** Qualities of the record (empty for FASTA). */
+    std::string_view quality;
+
+    /** \return the number of nucleotides. */
+    size_t size() const { return data.size(); }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+namespace impl
+{
+    /** \brief Content of a FASTA/FASTQ file.
+     *
+     * The file is memory mapped. If it can't be (pipe for instance), it is read by large blocks into memory.
+     */
+    class BankStorage
+    {
+    public:
+
+        BankStorage (const std::string& uri)
+        {
+            int fd = ::open (uri.c_str(), O_RDONLY);
+            if (fd < 0)  {  throw std::runtime_error (std::string{"unable to open bank "} + uri);  }
+
+            struct stat st;
+            if (::fstat (fd, &st)==0 and S_ISREG(st.st_mode) and st.st_size>0)
+            {
+                void* addr = ::mmap (nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr != MAP_FAILED)
+                {
+                    ::madvise (addr, st.st_size, MADV_SEQUENTIAL);
+                    mapped_ = addr;
+                    data_   = (const char*) addr;
+                    size_   = st.st_size;
+                }
+            }
+
+            if (mapped_ == nullptr)
+            {
+                // Fallback: buffered reads by large blocks.
+                constexpr size_t BLOCK = 1<<22;
+                ssize_t n = 0;
+                do
+                {
+                    buffer_.resize (size_+BLOCK);
+                    n = ::read (fd, buffer_.data()+size_, BLOCK);
+                    if (n>0)  { size_ += n; }
+                }
+                while (n>0);
+
+                buffer_.resize (size_);
+                data_ = buffer_.data();
+
+                if (n<0)  {  ::close(fd);  throw std::runtime_error (std::string{"unable to read bank "} + uri);  }
+            }
+
+            ::close (fd);
+
+            fastq_ = detectFastq();
+        }
+
+        ~BankStorage()  {  if (mapped_ != nullptr)  {  ::munmap (mapped_, size_);  }  }
+
+        BankStorage (const BankStorage&) = delete;
+        BankStorage& operator= (const BankStorage&) = delete;
+
+        const char* data() const { return data_; }
+        size_t      size() const { return size_; }
+
+        /** \return true if the content is in FASTQ format. */
+        bool isFastq() const { return fastq_; }
+
+    private:
+        void*       mapped_ = nullptr;
+        std::string buffer_;
+        const char* data_   = nullptr;
+        size_t      size_   = 0;
+        bool        fastq_  = false;
 
+        /** The format is given by the first character of the first record: we skip the leading
+         * blank lines and the comment lines (starting with ';' or '#') that may precede it. */
+        bool detectFastq() const
+        {
+            size_t p = 0;
+            while (p<size_)
+            {
+                char c = data_[p];
+                if (c==' ' or c=='\t' or c=='\r' or c=='\n')  {  p++;  continue;  }
+                if (c!=';' and c!='#')  {  return c=='@';  }
+
+                auto* e = (const char*) std::memchr (data_+p, '\n', size_-p);
+                p = e ? e-data_+1 : size_;
+            }
+            return false;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief View on the records of a FASTA/FASTQ bank whose header starts in a given range of bytes.
+ *
+ * Since each record belongs to the view holding its first byte, the views built on contiguous
+ * ranges of bytes partition the records of the bank: this is how a bank is split (see SplitOperator).
+ *
+ * The records are provided without any heap allocation, except for multi-lines FASTA sequences
+ * that have to be concatenated in a buffer owned by the iterator (and reused from one record to another).
+ *
+ * NOTE: FASTQ records are supposed to have their nucleotides and qualities on a single line each.
+ */
+class BankFastaView
+{
 public:
 
-    BankFasta (const std::string& uri) : uri_(uri)  {}
+    /** This class is not parseable, which means that its attributes won't be
+     * recursively analyzed by some type traits (see bpl::CounterTrait for instance)
+     */
+    static constexpr bool parseable = false;
 
-    iterator begin() const { return iterator (uri_); }
-    iterator end  () const { return iterator ();     }
+    BankFastaView () = default;
 
-private:
+    /** Constructor.
+     * \param storage : the content of the bank
+     * \param first : first byte of the range
+     * \param last : last byte (excluded) of the range
+     */
+    BankFastaView (std::shared_ptr<const impl::BankStorage> storage, size_t first, size_t last)
+        : storage_(std::move(storage)), first_(first), last_(last)  {}
 
+    /** \brief Iterator on the records of the view. */
     struct iterator
     {
-        iterator (const std::string& uri="") : uri_(uri) {}
+        iterator () = default;
+
+        iterator (const BankFastaView* ref, size_t pos) : ref_(ref), pos_(pos)  {  load();  }
+
+        iterator (const iterator& other)  {  *this = other;  }
+
+        iterator& operator= (const iterator& other)
+        {
+            ref_    = other.ref_;
+            pos_    = other.pos_;
+            next_   = other.next_;
+            record_ = other.record_;
+            buffer_ = other.buffer_;
+
+            // The nucleotides may refer to the buffer of the other iterator.
+            if (not other.buffer_.empty() and record_.data.data()==other.buffer_.data())  {  record_.data = buffer_;  }
+
+            return *this;
+        }
+
+        bool operator!= (const iterator& other) const { return pos_ != other.pos_; }
+        bool operator== (const iterator& other) const { return pos_ == other.pos_; }
+
+        const SequenceRecord& operator* () const { return record_;  }
+        const SequenceRecord* operator->() const { return &record_; }
+
+        iterator& operator++ ()  {  pos_ = next_;  load();  return *this;  }
+
+    private:
+
+        const BankFastaView* ref_  = nullptr;
+        size_t               pos_  = npos;
+        size_t               next_ = npos;
+        SequenceRecord       record_;
+        std::string          buffer_;
+
+        void load()
+        {
+            if (pos_ >= ref_->last_ or pos_ >= ref_->nbBytesTotal())  {  pos_ = npos;  return;  }
+
+            const char* data = ref_->storage_->data();
+            size_t      size = ref_->storage_->size();
+
+            size_t p = pos_;
+
+            auto readLine = [&] ()
+            {
+                size_t b = p;
+                auto*  e = (const char*) std::memchr (data+b, '\n', size-b);
+                size_t n = e ? e-data : size;
+                p = e ? n+1 : size;
+                if (n>b and data[n-1]=='\r')  { n--; }
+                return std::string_view (data+b, n-b);
+            };
+
+            record_.id = readLine().substr(1);
 
-        bool operator!=(const iterator& other)  { return false; }
-        const Sequence<SEQSIZE>& operator*() const { return currentSeq_; }
-        iterator& operator++() { return *this; }
+            if (data[pos_]=='@')
+            {
+                record_.data    = readLine();
+                readLine();
+                record_.quality = readLine();
+            }
+            else
+            {
+                record_.quality = {};
+                record_.data    = readLine();
 
-        std::string uri_;
-        Sequence<SEQSIZE> currentSeq_;
+                // Multi-lines sequence -> we have to concatenate the lines.
+                if (p<size and data[p]!='>')
+                {
+                    buffer_.assign (record_.data);
+                    while (p<size and data[p]!='>')  {  buffer_.append (readLine());  }
+                    record_.data = buffer_;
+                }
+            }
+
+            next_ = ref_->firstRecord (p);
+        }
     };
 
+    /** \return a iterator starting at the first record of the view. */
+    iterator begin() const  { return iterator (this, storage_ ? firstRecord (first_) : npos); }
+
+    /** \return an ending iterator. */
+    iterator end  () const  { return iterator (); }
+
+    /** Iterate the view through a provided functor.
+     * \param fct: the functor called with (1) the index of the record in the view
+     * and (2) the record itself.
+     */
+    template<typename FUNCTOR>
+    void iterate (FUNCTOR fct) const
+    {
+        std::size_t i=0;
+        for (auto it=begin(); it!=end(); ++it)  { fct (i++, *it); }
+    }
+
+    /** \return the first byte of the range. */
+    size_t first() const { return first_; }
+
+    /** \return the last byte (excluded) of the range. */
+    size_t last () const { return last_;  }
+
+    /** \return the number of bytes of the range. */
+    size_t nbBytes() const { return last_ - first_; }
+
+    /** \return the number of bytes of the whole bank. */
+    size_t nbBytesTotal() const { return storage_ ? storage_->size() : 0; }
+
+    /** \return true if the bank is in FASTQ format. */
+    bool isFastq () const { return storage_ and storage_->isFastq(); }
+
+    /** Get the sub view on a given range of bytes.
+     * \param first : first byte of the range (relative to the view)
+     * \param last : last byte (excluded) of the range (relative to the view)
+     * \return the sub view
+     */
+    BankFastaView subview (size_t first, size_t last) const
+    {
+        return BankFastaView (storage_, first_+first, first_+last);
+    }
+
+private:
+
+    static constexpr size_t npos = ~size_t(0);
+
+    std::shared_ptr<const impl::BankStorage> storage_;
+    size_t first_ = 0;
+    size_t last_  = 0;
+
+    /** Find the first record starting at a position greater or equal than the given one. */
+    size_t firstRecord (size_t pos) const
+    {
+        const char* data = storage_->data();
+        size_t      size = storage_->size();
+
+        char marker = isFastq() ? '@' : '>';
+
+        auto nextLine = [&] (size_t p) -> size_t
+        {
+            auto* e = (const char*) std::memchr (data+p, '\n', size-p);
+            return e ? e-data+1 : size;
+        };
+
+        // We go to the beginning of the next line if we are not at the beginning of a line.
+        if (pos>0 and pos<size and data[pos-1]!='\n')  {  pos = nextLine (pos);  }
+
+        for ( ; pos<size and pos<last_; pos = nextLine(pos))
+        {
+            if (data[pos] != marker)  { continue; }
+
+            if (marker=='>')  { return pos; }
+
+            // A FASTQ quality line may start with '@' too. A header is followed two lines later by the '+' line,
+            // whereas a quality line is followed two lines later by the nucleotides of the next record.
+            size_t p2 = nextLine (nextLine (pos));
+            if (p2<size and data[p2]=='+')  { return pos; }
+        }
+
+        return npos;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief FASTA/FASTQ bank.
+ *
+ * The file is memory mapped, the records are iterated without any copy (see BankFastaView) and the
+ * bank can be split (ie. 'split(bank)' as a Launcher::run argument) into views holding balanced
+ * ranges of bytes aligned on records boundaries.
+ *
+ * The format (FASTA or FASTQ) is guessed from the first character of the first record, after the
+ * potential leading blank lines and comment lines (starting with ';' or '#').
+ */
+class BankFasta : public BankFastaView
+{
+public:
+
+    /** Constructor.
+     * \param uri : path of the FASTA/FASTQ file.
+     */
+    BankFasta (const std::string& uri) : BankFasta (uri, std::make_shared<const impl::BankStorage>(uri))  {}
+
+    /** \return the path of the file. */
+    const std::string& uri() const { return uri_; }
+
+private:
+
+    BankFasta (const std::string& uri, std::shared_ptr<const impl::BankStorage> storage)
+        : BankFastaView (storage, 0, storage->size()), uri_(uri)  {}
+
     std::string uri_;
 };
 
+//////////////////////////////////////////////////////////////////////////////////////////
+/** \brief Template specialization of SplitOperator for the BankFastaView type.
+ * The view is split into ranges of bytes; each record belongs to the part holding its first byte.
+ * \see bpl::SplitOperator. */
+template<>
+struct SplitOperator<bpl::BankFastaView>
+{
+    static auto split (const bpl::BankFastaView& x, std::size_t idx, std::size_t total)
+    {
+        size_t i0 = x.nbBytes() * (idx+0) / total;
+        size_t i1 = x.nbBytes() * (idx+1) / total;
+        return x.subview (i0, i1);
+    }
+
+    static auto split_view (const bpl::BankFastaView& x, std::size_t idx, std::size_t total)
+    {  return split (x, idx, total);  }
+};
+
+/** \brief Template specialization of SplitOperator for the BankFasta type.
+ * \see bpl::SplitOperator. */
+template<>
+struct SplitOperator<bpl::BankFasta> : SplitOperator<bpl::BankFastaView>  {};
+
 ////////////////////////////////////////////////////////////////////////////////
 };  // end of namespace
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,300 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <bpl/core/Launcher.hpp>
+#include <bpl/arch/ArchMulticore.hpp>
+#include <bpl/bank/BankFasta.hpp>
+#include <string_view>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+/** \brief Iterate the canonical k-mers of a sequence.
+ *
+ * The forward and reverse complement 2 bits encodings of the k-mer are updated in constant time
+ * for each new nucleotide (rolling encoding); the canonical k-mer is the minimum of both. Any
+ * character not in ACGT (lower case accepted) resets the window, so k-mers holding such a
+ * character are skipped.
+ *
+ * \param seq: the sequence
+ * \param k: the k-mer size (between 1 and 32)
+ * \param fct: functor called with the 2 bits encoding (A=0,C=1,G=2,T=3) of each canonical k-mer.
+ */
+template<typename FUNCTOR>
+void iterateCanonicalKmers (std::string_view seq, std::size_t k, FUNCTOR fct)
+{
+    static constexpr auto table = [] {
+        std::array<uint8_t,256> t {};
+        for (auto& x : t)  { x = 4; }
+        t['A'] = t['a'] = 0;  t['C'] = t['c'] = 1;  t['G'] = t['g'] = 2;  t['T'] = t['t'] = 3;
+        return t;
+    } ();
+
+    if (k==0 or k>32)  { return; }
+
+    const uint64_t mask  = k==32 ? ~uint64_t(0) : (uint64_t(1) << (2*k)) - 1;
+    const std::size_t sh = 2*(k-1);
+
+    uint64_t    fwd = 0;
+    uint64_t    rev = 0;
+    std::size_t len = 0;
+
+    for (unsigned char c : seq)
+    {
+        uint64_t x = table[c];
+
+        if (x==4)  { len=0; fwd=0; rev=0; continue; }
+
+        fwd = ((fwd << 2) | x) & mask;
+        rev = (rev >> 2) | ((3-x) << sh);
+
+        if (++len >= k)  {  fct (std::min (fwd,rev));  }
+    }
+}
+
+/** \brief Hash of a k-mer encoding (finalizer of MurmurHash3, which is a bijection on 64 bits). */
+inline uint64_t hashKmer (uint64_t x)
+{
+    x ^= x >> 33;  x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;  x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Bottom-s MinHash sketch: keeps the s smallest distinct hash values inserted.
+ *
+ * The candidates lower than the current threshold are accumulated and pruned only when their
+ * number reaches 2*s, so the insertion is amortized constant time without any allocation once
+ * the first sketches are built (the object can be reused through 'clear').
+ *
+ * \param HASH: type of the hash values of the sketch (uint32_t for the SketchJaccard tasks).
+ */
+template<typename HASH=uint32_t>
+class MinHashSketch
+{
+public:
+
+    using hash_t = HASH;
+
+    /** Value used for completing a sketch of a sequence having less than s distinct k-mers. It keeps the
+     * sketch sorted, but it may also be a hash value: the number of real values of a sketch is given by
+     * 'flush' (see MinHashBuilder). */
+    static constexpr hash_t PADDING = std::numeric_limits<hash_t>::max();
+
+    /** Constructor.
+     * \param s : the sketch size. */
+    MinHashSketch (std::size_t s) : s_(s)  {  candidates_.reserve (2*s_+1);  }
+
+    /** Insert a hash value.
+     * \param h: the hash value. */
+    void add (hash_t h)
+    {
+        if (h >= threshold_ or s_==0)  { return; }
+
+        candidates_.push_back (h);
+
+        if (candidates_.size() >= 2*s_)  {  prune();  }
+    }
+
+    /** Insert the canonical k-mers of a sequence.
+     * \param seq: the sequence
+     * \param k: the k-mer size */
+    void addSequence (std::string_view seq, std::size_t k)
+    {
+        // We keep the most significant bits of the 64 bits hash.
+        iterateCanonicalKmers (seq, k, [&] (uint64_t kmer)  {  add (hash_t (hashKmer(kmer) >> (64-8*sizeof(hash_t))));  });
+    }
+
+    /** Append the sketch (s sorted values, completed with PADDING if needed) to a vector and clear the sketch.
+     * \param out: the vector the sketch is appended to.
+     * \return the number of real values of the sketch, ie. without the PADDING values that complete it. */
+    template<typename OUT>
+    std::size_t flush (OUT& out)
+    {
+        prune();
+        std::size_t length = candidates_.size();
+        out.insert (out.end(), candidates_.begin(), candidates_.end());
+        for (std::size_t i=length; i<s_; i++)  { out.push_back (PADDING); }
+        clear();
+        return length;
+    }
+
+    /** Clear the sketch. */
+    void clear ()
+    {
+        candidates_.clear();
+        threshold_ = PADDING;
+    }
+
+    /** \return the sketch size. */
+    std::size_t size() const { return s_; }
+
+private:
+
+    std::size_t         s_;
+    hash_t              threshold_ = PADDING;
+    std::vector<hash_t> candidates_;
+
+    void prune ()
+    {
+        std::sort (candidates_.begin(), candidates_.end());
+        candidates_.erase (std::unique (candidates_.begin(), candidates_.end()), candidates_.end());
+
+        if (candidates_.size() >= s_)
+        {
+            candidates_.resize (s_);
+            threshold_ = candidates_.back();
+        }
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Task computing the MinHash sketches of the records of a bank (or of a part of a bank).
+ *
+ * The result is the flat concatenation of the sketches (s sorted hash values per record) in
+ * the records order, with the number of real values of each sketch.
+ */
+template<class ARCH>
+struct MinHashTask : bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    using hash_t = uint32_t;
+
+    struct result_t
+    {
+        std::vector<hash_t>   sketches;
+        std::vector<uint32_t> lengths;
+    };
+
+    auto operator() (const bpl::BankFastaView& bank, std::size_t k, std::size_t s)
+    {
+        result_t result;
+
+        MinHashSketch<hash_t> sketch (s);
+
+        for (auto&& record : bank)
+        {
+            sketch.addSequence (record.data, k);
+            result.lengths.push_back (sketch.flush (result.sketches));
+        }
+
+        return result;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Builder of MinHash sketches for a whole bank.
+ *
+ * The bank is split by records among the threads of the multicore launcher, and the partial
+ * results are gathered in the flat layout expected by the SketchJaccard tasks, ie. the sketch of
+ * the record i is made of the s sorted values starting at i*s (s being then the 'ssize' argument
+ * of SketchJaccardDistance).
+ *
+ * NOTE: a sketch of a record having less than s distinct canonical k-mers is completed with
+ * MinHashSketch::PADDING values. SketchJaccardDistance compares whole sketches, so the padding values
+ * of two such sketches are counted as common values; in order to compare only the real values, get
+ * the length of each sketch from 'build' and give them to SketchDistanceEngine::compute.
+ */
+class MinHashBuilder
+{
+public:
+
+    using hash_t = MinHashTask<ArchMulticore>::hash_t;
+
+    /** Constructor.
+     * \param k : k-mer size (between 1 and 32)
+     * \param s : sketch size
+     */
+    MinHashBuilder (std::size_t k, std::size_t s) : k_(k), s_(s)  {}
+
+    /** Compute the sketches of the records of a bank.
+     * \param launcher : the launcher used for parallelizing the computation
+     * \param bank : the bank
+     * \param lengths : filled with the number of real values of each sketch (see MinHashSketch::PADDING)
+     * \return the flat vector of sketches
+     */
+    std::vector<hash_t> build (Launcher<ArchMulticore>& launcher, const bpl::BankFastaView& bank, std::vector<uint32_t>& lengths) const
+    {
+        auto parts = launcher.run<MinHashTask> (split(bank), k_, s_);
+
+        std::size_t nb = 0;
+        for (auto const& part : parts)  { nb += part.sketches.size(); }
+
+        std::vector<hash_t> result;
+        result.reserve (nb);
+        lengths.clear();
+        lengths.reserve (nb / std::max (s_, std::size_t(1)));
+
+        for (auto const& part : parts)
+        {
+            result.insert  (result.end(),  part.sketches.begin(), part.sketches.end());
+            lengths.insert (lengths.end(), part.lengths.begin(),  part.lengths.end());
+        }
+
+        return result;
+    }
+
+    /** Compute the sketches of the records of a bank.
+     * \param launcher : the launcher used for parallelizing the computation
+     * \param bank : the bank
+     * \return the flat vector of sketches
+     */
+    std::vector<hash_t> build (Launcher<ArchMulticore>& launcher, const bpl::BankFastaView& bank) const
+    {
+        std::vector<uint32_t> lengths;
+        return build (launcher, bank, lengths);
+    }
+
+    /** Compute the sketch of a single sequence.
+     * \param seq : the sequence
+     * \param length : set to the number of real values of the sketch (see MinHashSketch::PADDING)
+     * \return the s sorted hash values of the sketch
+     */
+    std::vector<hash_t> build (std::string_view seq, std::size_t& length) const
+    {
+        std::vector<hash_t> result;
+        MinHashSketch<hash_t> sketch (s_);
+        sketch.addSequence (seq, k_);
+        length = sketch.flush (result);
+        return result;
+    }
+
+    /** Compute the sketch of a single sequence.
+     * \param seq : the sequence
+     * \return the s sorted hash values of the sketch
+     */
+    std::vector<hash_t> build (std::string_view seq) const
+    {
+        std::size_t length = 0;
+        return build (seq, length);
+    }
+
+    /** \return the k-mer size. */
+    std::size_t kmerSize() const { return k_; }
+
+    /** \return the sketch size. */
+    std::size_t sketchSize() const { return s_; }
+
+private:
+
+    std::size_t k_;
+    std::size_t s_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,256 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <bpl/bank/Sequence.hpp>
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+namespace impl
+{
+    /** \brief Bit mask telling which nucleotides of a packed sequence are 'N' (one bit per nucleotide).
+     * The specialization for 0 words takes no memory at all (empty base class).
+     */
+    template<std::size_t NBWORDS>
+    struct PackedSequenceMask
+    {
+        uint64_t mask [NBWORDS];
+    };
+
+    template<>
+    struct PackedSequenceMask<0>  {};
+}
+
+/** \brief Sequence of a fixed number of nucleotides, each one encoded on 2 bits.
+ *
+ * It takes 4 times less memory than bpl::Sequence (and so 4 times less data to be broadcasted
+ * to the PIM units), while providing the same API for iterating the characters.
+ *
+ * The encoding is (c>>1)&3, ie. A=0, C=1, T=2, G=3 (same order as Sequence::nucleotids), so that
+ * the complement of a nucleotide is obtained by flipping its high bit. Nucleotide i is held by the
+ * bits [2*(i%32), 2*(i%32)+2) of the word i/32; the unused bits of the last word are always 0.
+ *
+ * Since the structure is trivially copyable, it can be serialized as is (for instance inside a BankChunk).
+ *
+ * The comparison kernels (hamming, nbCommon, reverseComplement) work on whole 64 bits words (32
+ * nucleotides at once) with popcount, and their loops over the words can be vectorized by the compiler.
+ *
+ * \param S: the number of nucleotides of the sequence.
+ * \param WITH_N: if true, a bit mask tells which nucleotides are 'N' (any character not in ACGT).
+ */
+template<std::size_t S, bool WITH_N=false>
+struct PackedSequence : impl::PackedSequenceMask<WITH_N ? (S+63)/64 : 0>
+{
+    /** Type of the words holding the nucleotides. */
+    using word_t = uint64_t;
+
+    /** Number of nucleotides. */
+    static const std::size_t SIZE = S;
+
+    /** Number of nucleotides per word. */
+    static const std::size_t NB_PER_WORD = 4*sizeof(word_t);
+
+    /** Number of words holding the nucleotides. */
+    static const std::size_t NBWORDS = (S + NB_PER_WORD - 1) / NB_PER_WORD;
+
+    /** Array holding the nucleotides. */
+    word_t data [NBWORDS];
+
+    static constexpr uint8_t nucleotids[] = {'A', 'C', 'T', 'G' };
+
+    /** Default constructor: only 'A' nucleotides. */
+    PackedSequence ()
+    {
+        for (std::size_t w=0; w<NBWORDS; w++)  { data[w] = 0; }
+        if constexpr (WITH_N)  {  for (auto& m : this->mask)  { m = 0; }  }
+    }
+
+    /** Constructor from a non packed sequence.
+     * \param seq: the sequence to be packed. */
+    PackedSequence (const Sequence<S>& seq) : PackedSequence()
+    {
+        for (std::size_t i=0; i<SIZE; i++)  {  set (i, seq.data[i]);  }
+    }
+
+    /** Constructor from characters.
+     * \param str: the SIZE characters to be packed. */
+    PackedSequence (const char* str) : PackedSequence()
+    {
+        for (std::size_t i=0; i<SIZE; i++)  {  set (i, str[i]);  }
+    }
+
+    /** \return the number of nucleotides. */
+    size_t size() const { return SIZE; }
+
+    /** \return the 2 bits code of a nucleotide. */
+    uint8_t code (std::size_t i) const  {  return (data[i/NB_PER_WORD] >> (2*(i%NB_PER_WORD))) & 3;  }
+
+    /** \return true if the nucleotide is 'N' (always false without N mask). */
+    bool isN (std::size_t i) const
+    {
+        if constexpr (WITH_N)  {  return (this->mask[i/64] >> (i%64)) & 1;  }
+        else                   {  return false;                             }
+    }
+
+    /** \return the character of a nucleotide. */
+    uint8_t operator[] (std::size_t i) const  {  return isN(i) ? 'N' : nucleotids[code(i)];  }
+
+    /** Set a nucleotide.
+     * \param i: the index of the nucleotide
+     * \param c: the character of the nucleotide. Without N mask, non ACGT characters are encoded as (c>>1)&3.
+     */
+    void set (std::size_t i, uint8_t c)
+    {
+        word_t& w     = data[i/NB_PER_WORD];
+        std::size_t s = 2*(i%NB_PER_WORD);
+
+        uint8_t x = (c>>1) & 3;
+
+        if constexpr (WITH_N)
+        {
+            uint8_t u = c & ~0x20;  // upper case
+            bool  isN = not (u=='A' or u=='C' or u=='G' or u=='T');
+
+            if (isN)  { this->mask[i/64] |=  (uint64_t(1) << (i%64));  x = 0; }
+            else      { this->mask[i/64] &= ~(uint64_t(1) << (i%64));         }
+        }
+
+        w = (w & ~(word_t(3) << s)) | (word_t(x) << s);
+    }
+
+    /** Iterate the sequence through a functor. The functor will
+     * be called with (1) the index of the character and (2) the
+     * character itself. */
+    template<typename FUNCTOR>
+    void iterate (FUNCTOR fct) const
+    {
+        for (std::size_t i=0; i<SIZE; i++)  { fct (i, (*this)[i]);  }
+    }
+
+    /** Iterate in parallel two sequences through a functor.
+     * \param a: the first sequence to be iterated.
+     * \param b: the second sequence to be iterated.
+     * \param fct: the functor that will be called with each couple of characters
+     * from a and b.
+     *  */
+    template<typename FUNCTOR>
+    static void iterate (const PackedSequence& a, const PackedSequence& b, FUNCTOR fct)
+    {
+        for (std::size_t i=0; i<SIZE; i++)  {  fct (i, a[i], b[i]);  }
+    }
+
+    /** Hamming distance between two sequences, ie. number of positions with different nucleotides.
+     * A 'N' nucleotide is different from any nucleotide (including 'N').
+     * \param a: the first sequence
+     * \param b: the second sequence
+     * \return the number of mismatches. */
+    static std::size_t hamming (const PackedSequence& a, const PackedSequence& b)
+    {
+        constexpr word_t LOW = 0x5555555555555555ULL;
+
+        std::size_t result = 0;
+
+        if constexpr (not WITH_N)
+        {
+            for (std::size_t w=0; w<NBWORDS; w++)
+            {
+                word_t x = a.data[w] ^ b.data[w];
+                result += __builtin_popcountll ((x | (x>>1)) & LOW);
+            }
+        }
+        else
+        {
+            // The mismatches of a word (one bit out of two) are compacted on 32 bits in order to be combined with the N mask.
+            for (std::size_t w=0; w<NBWORDS; w++)
+            {
+                word_t x = a.data[w] ^ b.data[w];
+                word_t m = compact ((x | (x>>1)) & LOW);
+                word_t n = ((a.mask[w/2] | b.mask[w/2]) >> (32*(w%2))) & 0xFFFFFFFFULL;
+                result += __builtin_popcountll (m | n);
+            }
+        }
+
+        return result;
+    }
+
+    /** Number of positions with identical nucleotides ('N' excluded).
+     * \param a: the first sequence
+     * \param b: the second sequence
+     * \return the number of matches. */
+    static std::size_t nbCommon (const PackedSequence& a, const PackedSequence& b)  {  return SIZE - hamming (a,b);  }
+
+    /** Equality operator. */
+    bool operator== (const PackedSequence& other) const
+    {
+        for (std::size_t w=0; w<NBWORDS; w++)  {  if (data[w] != other.data[w])  { return false; }  }
+        if constexpr (WITH_N)  {  for (std::size_t w=0; w<sizeof(this->mask)/sizeof(this->mask[0]); w++)  {  if (this->mask[w] != other.mask[w])  { return false; }  }  }
+        return true;
+    }
+
+    /** Compute the reverse complement of the sequence.
+     * \return the reverse complement. */
+    PackedSequence reverseComplement () const
+    {
+        PackedSequence result;
+
+        // We reverse and complement each word, the words being taken in reverse order.
+        for (std::size_t w=0; w<NBWORDS; w++)  {  result.data[w] = revcompWord (data[NBWORDS-1-w]);  }
+
+        // The (complemented) unused nucleotides of the last word are now at the beginning -> we shift them out.
+        constexpr std::size_t shift = 2*(NBWORDS*NB_PER_WORD - SIZE);
+
+        if constexpr (shift > 0)
+        {
+            for (std::size_t w=0; w<NBWORDS; w++)
+            {
+                word_t hi = w+1<NBWORDS ? result.data[w+1] << (64-shift) : 0;
+                result.data[w] = (result.data[w] >> shift) | hi;
+            }
+        }
+
+        if constexpr (WITH_N)
+        {
+            for (std::size_t i=0; i<SIZE; i++)
+            {
+                if (isN(SIZE-1-i))  {  result.set (i, 'N');  }
+            }
+        }
+
+        return result;
+    }
+
+private:
+
+    /** Reverse the order of the 32 nucleotides of a word and complement them. */
+    static word_t revcompWord (word_t x)
+    {
+        x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+        x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        x = __builtin_bswap64 (x);
+        return x ^ 0xAAAAAAAAAAAAAAAAULL;   // complement: flip the high bit of each nucleotide
+    }
+
+    /** Compact the even bits of a word into its 32 low bits. */
+    static word_t compact (word_t x)
+    {
+        x &= 0x5555555555555555ULL;
+        x = (x | (x >>  1)) & 0x3333333333333333ULL;
+        x = (x | (x >>  2)) & 0x0F0F0F0F0F0F0F0FULL;
+        x = (x | (x >>  4)) & 0x00FF00FF00FF00FFULL;
+        x = (x | (x >>  8)) & 0x0000FFFF0000FFFFULL;
+        x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+        return x;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,277 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <bpl/core/Launcher.hpp>
+#include <bpl/arch/ArchMulticore.hpp>
+#include <bpl/utils/intersect.hpp>
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+namespace impl
+{
+    /** \brief Description of an all-vs-all computation, shared (read only) by all the tiles tasks.
+     *
+     * The reference sketches are cut into tiles of 'refTile' sketches and the query sketches into tiles
+     * of 'qryTile' sketches. The tile t is made of the reference tile t/nbQryTiles and of the query tile
+     * t%nbQryTiles, so that consecutive tiles share the same reference tile.
+     *
+     * Only the first refLengths[r] (resp. qryLengths[q]) values of a sketch are compared, or all its
+     * values if there are no lengths.
+     */
+    struct SketchTiling
+    {
+        const uint32_t* ref        = nullptr;
+        const uint32_t* qry        = nullptr;
+        const uint32_t* refLengths = nullptr;
+        const uint32_t* qryLengths = nullptr;
+        std::size_t     ssize      = 0;
+        std::size_t     nbRef      = 0;
+        std::size_t     nbQry      = 0;
+        std::size_t     refTile    = 1;
+        std::size_t     qryTile    = 1;
+        intersect_fct_t kernel     = nullptr;
+
+        std::size_t nbRefTiles() const { return (nbRef + refTile - 1) / refTile; }
+        std::size_t nbQryTiles() const { return (nbQry + qryTile - 1) / qryTile; }
+        std::size_t nbTiles   () const { return nbRefTiles() * nbQryTiles();       }
+    };
+
+    /** \brief Output matrix of an all-vs-all computation (the cell (r,q) being at offset r*nbQry+q), restricted
+     * to the tiles [first,second) of a SketchTiling.
+     *
+     * Splitting the matrix splits its tiles, so each task gets the part of the matrix made of the tiles it
+     * computes (see SketchDistanceTiles) and the parts never overlap.
+     */
+    struct SketchMatrix
+    {
+        uint16_t*                           data  = nullptr;
+        std::size_t                         nbQry = 0;
+        std::pair<std::size_t,std::size_t>  tiles;
+
+        /** \return the row of the reference sketch r. */
+        uint16_t* row (std::size_t r) const  {  return data + r*nbQry;  }
+    };
+}
+
+/** The part of the output matrix is built on the fly from the caller's matrix (see the 'output' tag). */
+template<>  struct tag_by_value<impl::SketchMatrix> : std::true_type {};
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Template specialization of SplitOperator for the output matrix of an all-vs-all computation:
+ * the tiles of the matrix are split as a std::pair interval would be.
+ * \see bpl::SplitOperator. */
+template<>
+struct SplitOperator<impl::SketchMatrix>
+{
+    using tiles_t = std::pair<std::size_t,std::size_t>;
+
+    static auto split (const impl::SketchMatrix& m, std::size_t idx, std::size_t total)
+    {  return impl::SketchMatrix { m.data, m.nbQry, SplitOperator<tiles_t>::split (m.tiles, idx, total) };  }
+
+    static auto split_view (const impl::SketchMatrix& m, std::size_t idx, std::size_t total)
+    {  return split (m, idx, total);  }
+
+    static auto split_interval (const impl::SketchMatrix& m, std::size_t i0, std::size_t i1)
+    {  return impl::SketchMatrix { m.data, m.nbQry, SplitOperator<tiles_t>::split_interval (m.tiles, i0, i1) };  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Task computing the tiles of its part of the output matrix of an all-vs-all sketches comparison.
+ *
+ * The counts are directly written into the part of the matrix (each tile owns its own cells, so no
+ * synchronization is needed). The result is the number of computed pairs.
+ */
+template<class ARCH>
+struct SketchDistanceTiles : bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    auto operator() (output<impl::SketchMatrix> out, const impl::SketchTiling& tiling)
+    {
+        std::size_t nbPairs = 0;
+
+        std::size_t nbQryTiles = tiling.nbQryTiles();
+
+        for (std::size_t t=out->tiles.first; t<out->tiles.second; t++)
+        {
+            std::size_t r0 = (t / nbQryTiles) * tiling.refTile;
+            std::size_t q0 = (t % nbQryTiles) * tiling.qryTile;
+            std::size_t r1 = std::min (r0 + tiling.refTile, tiling.nbRef);
+            std::size_t q1 = std::min (q0 + tiling.qryTile, tiling.nbQry);
+
+            // Both tiles are supposed to stay in cache while the (r1-r0)*(q1-q0) pairs are compared.
+            for (std::size_t r=r0; r<r1; r++)
+            {
+                const uint32_t* sketchRef = tiling.ref + r*tiling.ssize;
+                std::size_t     lenRef    = tiling.refLengths ? tiling.refLengths[r] : tiling.ssize;
+                uint16_t*       row       = out->row (r);
+
+                for (std::size_t q=q0; q<q1; q++)
+                {
+                    const uint32_t* sketchQry = tiling.qry + q*tiling.ssize;
+                    std::size_t     lenQry    = tiling.qryLengths ? tiling.qryLengths[q] : tiling.ssize;
+
+                    row[q] = uint16_t (tiling.kernel (sketchRef, lenRef, sketchQry, lenQry));
+                }
+            }
+
+            nbPairs += (r1-r0)*(q1-q0);
+        }
+
+        return nbPairs;
+    }
+
+    static std::size_t reduce (std::size_t a, std::size_t b)  { return a+b; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief All-vs-all comparison of two sets of sketches.
+ *
+ * SketchJaccardDistance streams all the reference sketches for each query sketch, so the reference
+ * sketches are read from memory once per query sketch. Here the reference and query sketches are cut
+ * into tiles small enough for a reference tile and a query tile to stay in cache together; the
+ * tiles are distributed over the threads of a multicore launcher (use its granularity for a dynamic
+ * scheduling) and the counts are written into a caller-provided nbRef x nbQry matrix, given to the tasks
+ * as an 'output' argument split by tiles.
+ *
+ * The sketches have the flat layout of SketchJaccardDistance (and MinHashBuilder), ie. the sketch i is
+ * made of the 'ssize' sorted values starting at i*ssize. The cell (r,q) of the matrix, at offset
+ * r*nbQry+q, holds the number of common values of the reference sketch r and of the query sketch q.
+ *
+ * NOTE: the SIMD kernels require strictly increasing values (see bpl::intersect_count). The sketches
+ * completed with padding values (see MinHashBuilder) must then be given with their lengths, so that only
+ * their real values are compared whatever the instruction set.
+ */
+class SketchDistanceEngine
+{
+public:
+
+    using hash_t  = uint32_t;
+    using count_t = uint16_t;
+
+    /** Constructor.
+     * \param ssize : number of values of a sketch
+     * \param cacheSize : number of bytes a reference tile and a query tile may occupy together
+     * \param level : instruction set used for comparing two sketches
+     */
+    SketchDistanceEngine (std::size_t ssize, std::size_t cacheSize = 1<<18, SimdLevel level = getSimdLevel())
+        : ssize_(ssize), kernel_ (getIntersectKernel(level))
+    {
+        if (ssize_==0)  {  throw std::runtime_error ("sketch size must be positive");  }
+
+        tile_ = std::max (cacheSize / (2*ssize_*sizeof(hash_t)), std::size_t(1));
+    }
+
+    /** Compare all the reference sketches to all the query sketches, each sketch having a number of
+     * real values (the next ones being padding values that are not compared).
+     * \param launcher : the launcher the tiles are distributed with
+     * \param ref : the reference sketches
+     * \param refLengths : number of real values of each reference sketch (empty if all are complete)
+     * \param qry : the query sketches
+     * \param qryLengths : number of real values of each query sketch (empty if all are complete)
+     * \param out : the output matrix, holding at least nbRef*nbQry items
+     * \return the number of compared pairs
+     */
+    std::size_t compute (
+        Launcher<ArchMulticore>&  launcher,
+        std::span<const hash_t>   ref,
+        std::span<const uint32_t> refLengths,
+        std::span<const hash_t>   qry,
+        std::span<const uint32_t> qryLengths,
+        std::span<count_t>        out
+    ) const
+    {
+        impl::SketchTiling tiling;
+
+        tiling.ref        = ref.data();
+        tiling.qry        = qry.data();
+        tiling.refLengths = refLengths.empty() ? nullptr : refLengths.data();
+        tiling.qryLengths = qryLengths.empty() ? nullptr : qryLengths.data();
+        tiling.ssize      = ssize_;
+        tiling.nbRef      = ref.size() / ssize_;
+        tiling.nbQry      = qry.size() / ssize_;
+        tiling.refTile    = tile_;
+        tiling.qryTile    = tile_;
+        tiling.kernel     = kernel_;
+
+        if (out.size() < tiling.nbRef*tiling.nbQry)  {  throw std::runtime_error ("output matrix too small");  }
+
+        auto checkLengths = [&] (std::span<const uint32_t> lengths, std::size_t nb)
+        {
+            if (lengths.empty())  { return; }
+            if (lengths.size() != nb)  {  throw std::runtime_error ("one length per sketch is required");  }
+            for (auto l : lengths)  {  if (l > ssize_)  {  throw std::runtime_error ("sketch length greater than the sketch size");  }  }
+        };
+        checkLengths (refLengths, tiling.nbRef);
+        checkLengths (qryLengths, tiling.nbQry);
+
+        if (tiling.nbTiles()==0)  { return 0; }
+
+        impl::SketchMatrix matrix { out.data(), tiling.nbQry, {0, tiling.nbTiles()} };
+
+        return launcher.run<SketchDistanceTiles> (split(matrix), tiling);
+    }
+
+    /** Compare all the reference sketches to all the query sketches, all of them being complete.
+     * \param launcher : the launcher the tiles are distributed with
+     * \param ref : the reference sketches
+     * \param qry : the query sketches
+     * \param out : the output matrix, holding at least nbRef*nbQry items
+     * \return the number of compared pairs
+     */
+    std::size_t compute (
+        Launcher<ArchMulticore>& launcher,
+        std::span<const hash_t>  ref,
+        std::span<const hash_t>  qry,
+        std::span<count_t>       out
+    ) const
+    {
+        return compute (launcher, ref, {}, qry, {}, out);
+    }
+
+    /** Compare all the reference sketches to all the query sketches into a new matrix.
+     * \param launcher : the launcher the tiles are distributed with
+     * \param ref : the reference sketches
+     * \param qry : the query sketches
+     * \return the nbRef x nbQry matrix
+     */
+    std::vector<count_t> compute (
+        Launcher<ArchMulticore>& launcher,
+        std::span<const hash_t>  ref,
+        std::span<const hash_t>  qry
+    ) const
+    {
+        std::vector<count_t> result ((ref.size()/ssize_) * (qry.size()/ssize_));
+        compute (launcher, ref, qry, result);
+        return result;
+    }
+
+    /** \return the sketch size. */
+    std::size_t sketchSize() const { return ssize_; }
+
+    /** \return the number of sketches of a tile. */
+    std::size_t tileSize() const { return tile_; }
+
+private:
+
+    std::size_t     ssize_;
+    std::size_t     tile_;
+    intersect_fct_t kernel_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
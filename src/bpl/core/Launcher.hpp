@@ -11,6 +11,7 @@
 #include <bpl/utils/metaprog.hpp>
 #include <bpl/utils/reduce.hpp>
 #include <bpl/utils/splitter.hpp>
+#include <bpl/utils/Executor.hpp>
 
 #include <tuple>
 #include <vector>
@@ -18,6 +19,10 @@
 #include <map>
 #include <thread>
 #include <any>
+#include <future>
+#include <mutex>
+#include <atomic>
+#include <memory>
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace bpl  {
@@ -73,6 +78,21 @@ public:
     template<typename... ARGS>
     Launcher (ARGS&&... args)  : arch_ (std::forward<ARGS>(args)...)  {}
 
+    /** Copy constructor. The pending runs of 'other' (see 'run_async') are waited first, since they use
+     * its architecture; the copy has no pending run.
+     * \param other : the launcher to be copied
+     */
+    Launcher (const Launcher& other)  : arch_ ((other.async_.wait(), other.arch_))  {}
+
+    /** Move constructor. The pending runs of 'other' are waited first, since they refer to 'other'.
+     * \param other : the launcher to be moved
+     */
+    Launcher (Launcher&& other)  : arch_ ((other.async_.wait(), std::move(other.arch_)))  {}
+
+    /** Assignments: the pending runs of both launchers are waited first. */
+    Launcher& operator= (const Launcher& other)  {  async_.wait();  other.async_.wait();  arch_ = other.arch_;             return *this;  }
+    Launcher& operator= (Launcher&& other)       {  async_.wait();  other.async_.wait();  arch_ = std::move(other.arch_);  return *this;  }
+
     /** Return the name of the architecture.
      * \return the architecture name
      */
@@ -130,25 +150,117 @@ public:
         // We delegate the execution to the architecture instance.
         auto result = arch_.template run<TASK,TRAITS...> (std::forward<ARGS>(args)...);
 
-        // We define a Reduce functor that can (or not) reduce the partial results.
-        Reduce<has_reduce<task_t>::value,task_t> reducer;
-
         DEBUG_LAUNCHER ("[Launcher::run] reducing  %ld items\n", result.size());
 
         // We return the reduced results.
-        auto res = reducer(result);
+        auto res = reduce<task_t> (result);
 
         DEBUG_LAUNCHER ("[Launcher::run] END\n");
 
         return res;
     }
 
+    /** Run a task asynchronously on the underlying architecture.
+     *
+     * The runs are processed as a pipeline by the workers of the process-wide executor: while a run is
+     * executed by the architecture, the results of the previous one are reduced. If the architecture can
+     * execute several runs at the same time ('concurrent_runs', as for ArchMulticore), the jobs of the next
+     * run also fill the process units left idle by the end of the current one; otherwise the executions
+     * are done one at a time, in the order of the calls.
+     *
+     * The arguments provided as lvalues (and the objects proxied by 'split') are not copied, so they must
+     * live until the result is available. The destruction of the launcher waits for the pending runs, and
+     * so do its copy and its move.
+     *
+     * \param[in] TASK: class/struct providing the task execution model
+     * \param[in] TRAITS: potential extra type information
+     * \param[in] args: input parameters for the task to be executed
+     * \return a std::future on the result of the run (same result as 'run')
+     */
+    template<template<typename ...> class TASK, typename...TRAITS, typename ...ARGS>
+    auto run_async (ARGS&&... args)
+    {
+        using task_t   = TASK<ARCH,TRAITS...>;
+        using result_t = decltype (std::declval<Launcher&>().template run<TASK,TRAITS...> (std::forward<ARGS>(args)...));
+
+        AsyncState& async = async_.get();
+
+        auto promise = std::make_shared<std::promise<result_t>>();
+        auto future  = promise->get_future();
+
+        async.execute.detach_task ([this, &async, promise, targs = std::tuple<ARGS...> (std::forward<ARGS>(args)...)] () mutable
+        {
+            try
+            {
+                auto res = std::apply ([&] (auto&&... a)
+                {
+                    return arch_.template run<TASK,TRAITS...> (std::forward<decltype(a)>(a)...);
+                }, std::move(targs));
+
+                auto results = std::make_shared<decltype(res)> (std::move(res));
+
+                // The reduction is done by another job, so the execution of the next run can begin.
+                async.collect.detach_task ([this, promise, results]
+                {
+                    try          {  promise->set_value (reduce<task_t> (*results));  }
+                    catch (...)  {  promise->set_exception (std::current_exception());  }
+                });
+            }
+            catch (...)  {  promise->set_exception (std::current_exception());  }
+        });
+
+        return future;
+    }
+
+    /** Run a task on the underlying architecture and provide each partial result to a sink, without
+     * gathering all the results first.
+     *
+     * The sink is called as sink(idx,result) for each process unit; calls are never concurrent. If the
+     * architecture provides a 'stream' method, the results are provided as soon as they are computed,
+     * possibly in another order than the units order. Otherwise, the results are provided in units order
+     * once the architecture has run the task.
+     *
+     * A bpl::OrderedReducer can be used as sink in order to reduce the results while the task is running.
+     *
+     * \param[in] TASK: class/struct providing the task execution model
+     * \param[in] TRAITS: potential extra type information
+     * \param[in] sink: callable receiving (index, result) for each process unit
+     * \param[in] args: input parameters for the task to be executed
+     */
+    template<template<typename ...> class TASK, typename...TRAITS, typename SINK, typename ...ARGS>
+    void stream (SINK&& sink, ARGS&&... args)
+    {
+        if constexpr (requires { arch_.template stream<TASK,TRAITS...> (sink, std::forward<ARGS>(args)...); })
+        {
+            arch_.template stream<TASK,TRAITS...> (sink, std::forward<ARGS>(args)...);
+        }
+        else
+        {
+            auto results = arch_.template run<TASK,TRAITS...> (std::forward<ARGS>(args)...);
+            for (std::size_t idx=0; idx<results.size(); idx++)  {  sink (idx, std::move(results[idx]));  }
+        }
+    }
+
+    /** Load in advance what the architecture needs for running a task (the binary on the DPUs for UPMEM),
+     * so that the first 'run' of the task doesn't pay for it. Nothing is done if the architecture doesn't need it.
+     * \param[in] TASK: class/struct providing the task execution model
+     * \param[in] TRAITS: potential extra type information
+     */
+    template<template<typename ...> class TASK, typename...TRAITS>
+    void preload()
+    {
+        if constexpr (requires (ARCH& a) { a.template preload<TASK,TRAITS...>(); })
+        {
+            arch_.template preload<TASK,TRAITS...>();
+        }
+    }
+
     /** Statistics about the launcher aggregated during execution of tasks through the 'run' method.
      * Delegated to the underlying architecture. Note that theses statistics are not reset between
      * 'run' calls.
-     * \return the bpl::Statistic object
+     * \return the bpl::Statistic object (a copy if the architecture may update it during the call)
      */
-    const auto& getStatistics() const
+    decltype(auto) getStatistics() const
     {
         return arch_.getStatistics();
     }
@@ -162,8 +274,88 @@ public:
 
 private:
 
+    /** Reduce (or not) the partial results. If the architecture provides a host thread pool,
+     * the reduction is done as a parallel tree reduction on it.
+     * \param results : the partial results returned by the architecture
+     * \return the reduced result or the partial results if TASK has no 'reduce' method.
+     */
+    template<typename TASK, typename RESULTS>
+    auto reduce (RESULTS& results)
+    {
+        // We define a Reduce functor that can (or not) reduce the partial results.
+        Reduce<has_reduce<TASK>::value,TASK> reducer;
+
+        if constexpr (requires { arch_.getThreadPool(); })  {  return reducer (results, arch_.getThreadPool());  }
+        else                                                {  return reducer (results);                         }
+    }
+
     /** Object representing the architecture. Most of the Launcher class will delegate the work to this object. */
     ARCH arch_;
+
+    /** \brief Pipeline of the runs submitted through 'run_async'. */
+    struct AsyncState
+    {
+        /** Maximum number of runs in progress in each stage of the pipeline. */
+        static constexpr std::size_t DEPTH = 3;
+
+        static constexpr bool concurrent = requires { requires ARCH::concurrent_runs; };
+
+        // The executions of an architecture that can't run several of them at the same time go through
+        // a lease of concurrency 1, which executes them in the order of the calls without blocking a worker.
+        AsyncState()
+            : execute (Executor::instance().lease (concurrent ? DEPTH : 1)),
+              collect (Executor::instance().lease (DEPTH))
+        {
+            // The runs of an architecture not using the executor block a worker during their execution.
+            if constexpr (not requires { ARCH::uses_executor; })  {  Executor::instance().reserve (DEPTH);  }
+        }
+
+        ~AsyncState()
+        {
+            // The reductions are submitted by the executions -> the executions are waited first.
+            execute.wait();
+            collect.wait();
+        }
+
+        ExecutorLease execute;
+        ExecutorLease collect;
+    };
+
+    /** Pointer on the pipeline, created at the first 'run_async' call (possibly made by several threads
+     * at the same time). The pending runs refer the launcher that submitted them, so a copied (or moved)
+     * launcher gets its own pipeline, once the runs of the source are over (see the Launcher constructors). */
+    class AsyncPtr
+    {
+    public:
+        AsyncPtr() = default;
+        AsyncPtr (const AsyncPtr&)  {}
+        AsyncPtr& operator= (const AsyncPtr&)  { return *this; }
+
+        /** \return the pipeline, created at the first call. */
+        AsyncState& get()
+        {
+            std::call_once (once_, [this]
+            {
+                state_ = std::make_unique<AsyncState>();
+                ready_.store (true, std::memory_order_release);
+            });
+            return *state_;
+        }
+
+        /** Wait for the pending runs (if any). */
+        void wait() const
+        {
+            if (ready_.load (std::memory_order_acquire))  {  state_->execute.wait();  state_->collect.wait();  }
+        }
+
+    private:
+        std::unique_ptr<AsyncState> state_;
+        std::once_flag              once_;
+        std::atomic<bool>           ready_ = false;
+    };
+
+    /** Declared after 'arch_', so that it is destroyed first (ie. the pending runs are over before). */
+    AsyncPtr async_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
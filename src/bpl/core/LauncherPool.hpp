@@ -9,14 +9,31 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include <mutex>
+#include <condition_variable>
 #include <any>
+#include <functional>
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <map>
+#include <typeindex>
+#include <stdexcept>
+#include <string>
+#include <exception>
 #include <bpl/core/Launcher.hpp>
-#include <BS_thread_pool.hpp>
+#include <bpl/utils/Executor.hpp>
+#include <bpl/utils/Statistics.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace bpl  {
 ////////////////////////////////////////////////////////////////////////////////
+
+/** \brief Priority of a submission to a LauncherPool: the pending submissions of higher priority are
+ * run first, the ones of the same priority in the order of the calls. */
+enum class Priority  {  LOW, NORMAL, HIGH  };
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /** \brief Pool of Launcher objects for a given architecture.
@@ -26,9 +43,24 @@ namespace bpl  {
  * is available.
  *
  * A pool is created with a number of launchers, all the other parameters are those
- * used by the constructor of Launcher. A thread is created for each pool, so ultimately,
- * we have a pool threads in the implementation. The BS::thread_pool is used under the hood
- * for managing this pool of threads.
+ * used by the constructor of Launcher. The submitted tasks are run by the workers of the
+ * process-wide bpl::Executor, through a lease allowing as many of them as launchers at the
+ * same time; each running task gets a launcher that is not used by another one.
+ *
+ * For architectures whose tasks mainly wait for a device (UPMEM for instance), the executor is
+ * asked for at least one worker per launcher. This is not needed for ArchMulticore, whose jobs are
+ * run by the same executor.
+ *
+ * The submissions wait in the pool until a launcher is available; they are then run by order of
+ * priority (see bpl::Priority). The number of pending submissions may be bounded ('setMaxPending'),
+ * in which case 'submit' blocks while the bound is reached. Small queries of the same task can be
+ * coalesced into a single run with 'submit_query'.
+ *
+ * By default, a launcher is created by the first task it runs; 'warmup' creates all of them in
+ * parallel beforehand (and may preload a task), so that the first tasks don't pay for it.
+ *
+ * An exception thrown by a task or by a callback doesn't stop the pool: the other submissions are
+ * run, and the first exception is rethrown by the next call to 'wait'.
  *
  * \param ARCH: architecture of the Launcher objects to be created for the pool.
  */
@@ -57,16 +89,24 @@ public:
     LauncherPool (size_t nbLaunchers, TUNIT units, ARGS&&... args)
         : nbunits_(nbLaunchers * units.getNbComponents())
     {
-        // We create the thread pool as a smart pointer.
-        threadpool_ = std::make_unique<BS::thread_pool<>> (nbLaunchers);
+        // We get a lease on the executor, allowing one task per launcher at the same time.
+        if constexpr (not requires { ARCH::uses_executor; })  {  Executor::instance().reserve (nbLaunchers);  }
+
+        threadpool_ = Executor::instance().lease (nbLaunchers);
 
         // We get a snapshot of the configuration.
         // It will be user later when an actual launcher will be requested for the first time.
         config_ = launcher_t::make_configuration (units, std::forward<ARGS>(args)...);
 
         launchers_.resize (nbLaunchers);
+        created_ = std::make_unique<std::once_flag[]> (nbLaunchers);
+
+        for (size_t i=0; i<nbLaunchers; i++)  {  available_.push_back (nbLaunchers-1-i);  }
     }
 
+    /** Destructor. The pending tasks are executed before (an exception not retrieved by 'wait' is dropped). */
+    ~LauncherPool()  {  threadpool_.wait();  }
+
     /** Get the number of components associated to the launcher pool. This is the sum
      * of components number for all launchers.
      * \return the total number of components.
@@ -80,51 +120,182 @@ public:
      * \param args: arguments to be provided to the task as input
      */
     template<template<typename ...> class Task, typename Callback, typename...Args>
+    requires (not std::is_same_v<std::decay_t<Callback>,Priority>)
     auto submit (Callback cbk, Args&&...args)
+    {
+        return submit<Task> (Priority::NORMAL, std::move(cbk), std::forward<Args>(args)...);
+    }
+
+    /** Submit a task to the pool of Launcher objects with a given priority.
+     * \param Task: type of the task to be run
+     * \param priority: priority of the task among the pending submissions
+     * \param cbk: callback that will be called at the end of the execution of the task. This
+     * callback takes as argument (1) the launcher that ran the task and (2) the result of the task.
+     * \param args: arguments to be provided to the task as input
+     */
+    template<template<typename ...> class Task, typename Callback, typename...Args>
+    auto submit (Priority priority, Callback cbk, Args&&...args)
     {
         // We need to be sure that the arguments to be used for task execution will have a life cycle long enough.
         // This is important for instance when we directly use 'split' on client side, which implies that this argument
         // is deleted as soon as the call to 'submit' is done. So we make sure here to keep the information in a 'Command'
-        // function object that will be used in the 'detach_task' call.
+        // function object that will be kept until the task is run.
         struct Command
         {
-            LauncherPool&       parent;
             Callback            cbk;
             std::tuple<std::decay_t<Args>...> args;
 
-            auto operator() ()
+            auto operator() (launcher_t& launcher)
             {
-                const std::optional<std::size_t> idx = BS::this_thread::get_index();
-
-                if (idx)
+                auto&& results = std::apply ([&] (auto&&... theargs)
                 {
-                    // We retrieve the launcher matching the current index
-                    launcher_t& launcher = parent.getLauncher(*idx);
+                    // We launch the task and return its result.
+                    return launcher.template run<Task> (std::forward<decltype(theargs)>(theargs)...);
 
-                    auto&& results = std::apply ([&] (auto&&... theargs)
-                    {
-                        // We launch the task and return its result.
-                        return launcher.template run<Task> (std::forward<decltype(theargs)>(theargs)...);
+                }, args);
 
-                    }, args);
-
-                    // We call the callback with the results
-                    cbk (launcher, std::move(results));
-                }
-                else
-                {
-                    throw std::runtime_error ("thread pool failed to process the task");
-                }
+                // We call the callback with the results
+                cbk (launcher, std::move(results));
             }
         };
-        threadpool_->detach_task ( Command { *this, cbk, std::make_tuple(args...) } );
+
+        std::unique_lock<std::mutex> lock (mutex_);
+        waitForRoom (lock);
+
+        // The arguments provided as rvalues are moved into the command.
+        queues_[size_t(priority)].push_back (Job { Command { std::move(cbk), std::tuple<std::decay_t<Args>...> (std::forward<Args>(args)...) }, nullptr });
+        nbPending_++;
+
+        lock.unlock();
+        threadpool_.detach_task ([this] {  process();  });
+    }
+
+    /** Submit a query to be coalesced with the other pending queries of the same task.
+     *
+     * The queries submitted with the same task, callback type and priority that are not started yet
+     * are gathered into a single run, which saves a run per query when the queries are small (sketch
+     * lookups for instance). The task receives the queries of the batch as a split vector (ie. a part of
+     * them for each process unit) and must return one result per query, in the order of its part.
+     * Each callback then receives the result of its own query.
+     *
+     * \param Task: type of the task to be run
+     * \param cbk: callback called with (1) the launcher that ran the batch and (2) the result of the query
+     * \param query: the query
+     * \param priority: priority of the query among the pending submissions
+     */
+    template<template<typename ...> class Task, typename Callback, typename Query>
+    void submit_query (Callback cbk, Query&& query, Priority priority = Priority::NORMAL)
+    {
+        using batch_t = Batch<Task, std::decay_t<Query>, Callback>;
+
+        std::unique_lock<std::mutex> lock (mutex_);
+        waitForRoom (lock);
+
+        nbPending_++;
+
+        // We look for a batch of the same kind not started yet.
+        auto& open = openBatches_[size_t(priority)];
+        auto  key  = std::type_index (typeid(batch_t));
+
+        if (auto it = open.find(key); it!=open.end() and (maxBatchSize_==0 or it->second->size() < maxBatchSize_))
+        {
+            static_cast<batch_t*>(it->second.get())->add (std::move(cbk), std::forward<Query>(query));
+            return;
+        }
+
+        auto batch = std::make_shared<batch_t>();
+        batch->add (std::move(cbk), std::forward<Query>(query));
+
+        open[key] = batch;
+        queues_[size_t(priority)].push_back (Job { [batch] (launcher_t& launcher)  {  (*batch) (launcher);  }, batch });
+
+        lock.unlock();
+        threadpool_.detach_task ([this] {  process();  });
+    }
+
+    /** Bound the number of submissions not started yet. When the bound is reached, 'submit' and 'submit_query'
+     * block until a submission is started, unless they are called by a worker of the executor (from a callback
+     * for instance), which would prevent the pending submissions to be run.
+     * \param n : maximum number of pending submissions (0 means no bound)
+     */
+    void setMaxPending (size_t n)
+    {
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            maxPending_ = n;
+        }
+        notFull_.notify_all();
+    }
+
+    /** Set the maximum number of queries coalesced into one run (see 'submit_query').
+     * \param n : the maximum number of queries (0 means no bound)
+     */
+    void setMaxBatchSize (size_t n)
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        maxBatchSize_ = n;
+    }
+
+    /** \return the number of submissions not started yet. */
+    size_t getNbPending() const
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        return nbPending_;
+    }
+
+    /** Create all the launchers of the pool in parallel, instead of letting the first task run by each
+     * launcher create it. This must be done before the first submission.
+     * The creation time of each launcher is provided by the statistics of the pool.
+     */
+    void warmup()
+    {
+        warmupWith ([] (size_t idx, launcher_t& launcher) {});
+    }
+
+    /** Create all the launchers of the pool in parallel and preload what they need for running a task
+     * (see Launcher::preload). This must be done before the first submission.
+     * \param TASK: the task to be preloaded
+     * \param TRAITS: potential extra type information
+     */
+    template<template<typename ...> class TASK, typename...TRAITS>
+    void warmup()
+    {
+        warmupWith ([this] (size_t idx, launcher_t& launcher)
+        {
+            double duration = 0;
+            {
+                TimeStamp ts (duration);
+                launcher.template preload<TASK,TRAITS...>();
+            }
+            std::lock_guard<std::mutex> lock (mutex_);
+            statistics_.addTiming ("startup/preload/" + std::to_string(idx), duration);
+        });
+    }
+
+    /** Statistics of the pool: creation time of each launcher ("startup/launcher/<idx>"), preload time of
+     * each launcher ("startup/preload/<idx>") and duration of the warm-up ("startup/warmup").
+     * The launchers may be created by the workers meanwhile, so a copy is returned, taken under the lock.
+     * \return the statistics
+     */
+    Statistics getStatistics() const
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        return statistics_;
     }
 
-    /** Synchronization for the pool.
+    /** Synchronization for the pool. The first exception thrown by a task or a callback since the previous
+     * call is rethrown once all the submissions are done.
      */
-    auto wait()
+    void wait()
     {
-        threadpool_->wait();
+        threadpool_.wait();
+
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            std::swap (error, error_);
+        }
+        if (error)  {  std::rethrow_exception (error);  }
     }
 
     /** Number of Launcher objects in the pool
@@ -148,18 +319,192 @@ private:
      * \return the Launcher object
      */
     launcher_t& getLauncher (size_t idx) {
-        std::lock_guard<std::mutex> g (mutex_);
-        // We might create the launcher if not existing
-        if (launchers_[idx].get()==nullptr) {
-            launchers_[idx] = launcher_t::create (config_);   }
+        // We might create the launcher if not existing; the launchers are created in parallel.
+        std::call_once (created_[idx], [&]
+        {
+            double duration = 0;
+            {
+                TimeStamp ts (duration);
+                launchers_[idx] = launcher_t::create (config_);
+            }
+            std::lock_guard<std::mutex> g (mutex_);
+            statistics_.addTiming ("startup/launcher/" + std::to_string(idx), duration);
+        });
         return *launchers_[idx];
     }
 
-    /** Mutex needed when calling getLauncher. */
-    std::mutex mutex_;
+    /** One flag per launcher, telling whether it has been created. */
+    std::unique_ptr<std::once_flag[]> created_;
+
+    /** Create all the launchers with the jobs of the lease, then call a function on each of them. */
+    template<typename FCT>
+    void warmupWith (FCT fct)
+    {
+        double duration = 0;
+        {
+            TimeStamp ts (duration);
+            threadpool_.submit_sequence (size_t(0), size(), [&] (size_t idx)  {  fct (idx, getLauncher(idx));  }).get();
+        }
+        std::lock_guard<std::mutex> lock (mutex_);
+        statistics_.addTiming ("startup/warmup", duration);
+    }
+
+    /** Statistics of the pool. */
+    Statistics statistics_;
+
+    /** \brief Queries coalesced into one run (see 'submit_query'). */
+    struct BatchBase
+    {
+        virtual ~BatchBase() {}
+        virtual size_t size() const = 0;
+    };
+
+    template<template<typename ...> class Task, typename Query, typename Callback>
+    struct Batch : BatchBase
+    {
+        std::vector<Query>    queries;
+        std::vector<Callback> callbacks;
+
+        size_t size() const override  { return queries.size(); }
+
+        template<typename Q>
+        void add (Callback&& cbk, Q&& query)
+        {
+            callbacks.push_back (std::move(cbk));
+            queries.push_back (std::forward<Q>(query));
+        }
+
+        void operator() (launcher_t& launcher)
+        {
+            // The results of the process units are in the order of the parts of the queries.
+            auto results = launcher.template run<Task> (split(queries));
+
+            size_t nb = 0;
+            for (auto const& part : results)  {  nb += std::size(part);  }
+
+            if (nb != queries.size())  {  throw std::runtime_error ("LauncherPool: a batched task must return one result per query");  }
+
+            // A throwing callback doesn't prevent the other queries from getting their result; the errors
+            // are reported once all the callbacks are called.
+            std::vector<std::exception_ptr> errors;
+
+            size_t i = 0;
+            for (auto&& part : results)
+            {
+                for (auto&& res : part)
+                {
+                    try          {  callbacks[i++] (launcher, std::move(res));  }
+                    catch (...)  {  errors.push_back (std::current_exception());  }
+                }
+            }
+
+            if (errors.size() == 1)  {  std::rethrow_exception (errors[0]);  }
+            if (errors.size()  > 1)
+            {
+                std::string first = "unknown error";
+                try                              {  std::rethrow_exception (errors[0]);  }
+                catch (const std::exception& e)  {  first = e.what();  }
+                catch (...)                      {}
+
+                throw std::runtime_error ("LauncherPool: " + std::to_string(errors.size()) + " callbacks of a batch failed, the first one with: " + first);
+            }
+        }
+    };
+
+    /** \brief Pending submission; 'batch' is set for coalesced queries. */
+    struct Job
+    {
+        std::function<void(launcher_t&)> fct;
+        std::shared_ptr<BatchBase>       batch;
+    };
+
+    /** Run the pending submission of highest priority. This is the job submitted to the lease for each
+     * submission (and each batch), so there is always a pending submission when it is called. */
+    void process()
+    {
+        Job job;
+        size_t idx = 0;
+        {
+            std::lock_guard<std::mutex> g (mutex_);
+
+            auto it = std::find_if (queues_.rbegin(), queues_.rend(), [] (auto const& q) { return not q.empty(); });
+            job = std::move (it->front());
+            it->pop_front();
+
+            // A started batch doesn't get new queries anymore.
+            size_t nb = 1;
+            if (job.batch)
+            {
+                auto& open = openBatches_[queues_.rend() - it - 1];
+                for (auto o = open.begin(); o!=open.end(); ++o)  {  if (o->second==job.batch)  { open.erase(o);  break; }  }
+                nb = job.batch->size();
+            }
+            nbPending_ -= nb;
+
+            // We get a launcher not used by another task (there is always one since the
+            // lease doesn't run more tasks than launchers at the same time).
+            idx = available_.back();
+            available_.pop_back();
+        }
+        notFull_.notify_all();
+
+        // The launcher is given back even if the job throws.
+        struct Release
+        {
+            LauncherPool& pool;
+            size_t        idx;
+            ~Release()  {  pool.release (idx);  }
+        } guard {*this, idx};
+
+        // An exception must not leave the job (the executor would terminate the program): the first one
+        // is kept for 'wait'.
+        try  {  job.fct (getLauncher(idx));  }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> g (mutex_);
+            if (not error_)  {  error_ = std::current_exception();  }
+        }
+    }
+
+    /** Wait until a new submission can be accepted (the mutex must be held). */
+    void waitForRoom (std::unique_lock<std::mutex>& lock)
+    {
+        if (Executor::getWorkerIndex())  { return; }
+        notFull_.wait (lock, [this] { return maxPending_==0 or nbPending_ < maxPending_; });
+    }
+
+    /** Give back a launcher used by 'process'. */
+    void release (size_t idx)
+    {
+        std::lock_guard<std::mutex> g (mutex_);
+        available_.push_back (idx);
+    }
+
+    /** Mutex needed when calling process, the submissions and when updating the statistics. */
+    mutable std::mutex mutex_;
+
+    /** Indexes of the launchers not used by a running task. */
+    std::vector<size_t> available_;
+
+    /** Pending submissions, one queue per priority. */
+    std::array<std::deque<Job>,3> queues_;
+
+    /** Batches of each priority not started yet, by type. */
+    std::array<std::map<std::type_index,std::shared_ptr<BatchBase>>,3> openBatches_;
+
+    /** Number of pending submissions (a batch counts for its number of queries). */
+    size_t nbPending_ = 0;
+
+    size_t maxPending_   = 0;
+    size_t maxBatchSize_ = 0;
+
+    std::condition_variable notFull_;
+
+    /** First exception thrown by a job since the last call to 'wait'. */
+    std::exception_ptr error_;
 
-    /** The thread pool using the BS::thread_pool library. */
-    std::unique_ptr<BS::thread_pool<>> threadpool_;
+    /** The lease on the process-wide executor. */
+    ExecutorLease threadpool_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
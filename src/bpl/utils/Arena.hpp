@@ -0,0 +1,257 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+/** \brief Bump allocator owned by a thread, used for the task local allocations on the multicore side.
+ *
+ * This is the host counterpart of the MRAM allocator of the DPU: an allocation only moves a position
+ * forward in a chunk of memory, so the threads of a run don't compete for the global heap lock.
+ * The arena of a thread serves allocations only while a Scope is active on this thread (ie. during the
+ * execution of a task). When a scope begins, the allocations start again from the first chunk having no
+ * live allocation, if any before the current one; otherwise (the results of the previous tasks are still
+ * alive in the current chunk) they go on after the live ones. The chunks still holding live allocations
+ * (a result escaping from a task for instance) are skipped, so that an escaping result only keeps its own
+ * chunks: the arena doesn't grow as long as the results of the previous runs are released. The chunks
+ * are kept for the next runs and only released with the arena.
+ *
+ * Memory of an arena may be released by any thread (a result freed by the caller for instance); only
+ * the owner thread allocates from it.
+ */
+class Arena
+{
+public:
+
+    /** Size of the first chunk; the next ones are twice as large, up to 256 times this size. */
+    static constexpr std::size_t FIRST_CHUNK = std::size_t(1) << 16;
+
+    /** Maximum number of chunks (once reached, the allocations go to the heap). */
+    static constexpr std::size_t MAX_CHUNKS  = 48;
+
+    /** Allocations larger than this go to the heap. */
+    static constexpr std::size_t LARGE       = std::size_t(1) << 20;
+
+    /** Alignment of the allocations. */
+    static constexpr std::size_t ALIGN       = alignof(std::max_align_t);
+
+    /** RAII object making the arena of the calling thread serve allocations during its lifetime. */
+    class Scope
+    {
+    public:
+        Scope()  : arena_(local())  {  arena_->enter();  }
+        ~Scope()                    {  arena_->depth_--; }
+
+        Scope (const Scope&) = delete;
+        Scope& operator= (const Scope&) = delete;
+
+    private:
+        std::shared_ptr<Arena> arena_;
+    };
+
+    /** \return the arena of the calling thread. */
+    static const std::shared_ptr<Arena>& local()
+    {
+        thread_local std::shared_ptr<Arena> arena = std::make_shared<Arena>();
+        return arena;
+    }
+
+    /** \return the arena of the calling thread if a scope is active, null otherwise. */
+    static std::shared_ptr<Arena> current()
+    {
+        auto const& arena = local();
+        return arena->depth_ > 0 ? arena : nullptr;
+    }
+
+    Arena() = default;
+    Arena (const Arena&) = delete;
+    Arena& operator= (const Arena&) = delete;
+
+    ~Arena()
+    {
+        for (std::size_t k=0; k<nbChunks_; k++)  {  delete[] chunks_[k].load();  }
+    }
+
+    /** Allocate some bytes.
+     * \param size : number of bytes
+     * \return the allocated memory, null if the arena can't serve the request (the caller then uses the heap)
+     */
+    void* allocate (std::size_t size)
+    {
+        if (local().get()!=this or depth_==0 or size>LARGE)  { return nullptr; }
+
+        size = round (size);
+
+        while (true)
+        {
+            if (current_ < nbChunks_)
+            {
+                if (pos_+size <= chunkSize(current_))
+                {
+                    char* result = chunks_[current_].load (std::memory_order_relaxed) + pos_;
+                    pos_ += size;
+                    chunkLive_[current_]++;
+                    live_++;
+                    return result;
+                }
+                next (current_+1);
+            }
+            else
+            {
+                if (nbChunks_ == MAX_CHUNKS)  { return nullptr; }
+                chunks_[nbChunks_].store (new char [chunkSize(nbChunks_)], std::memory_order_release);
+                nbChunks_++;
+                nbChunksPublished_.store (nbChunks_, std::memory_order_release);
+            }
+        }
+    }
+
+    /** Release memory.
+     * \param ptr : the memory
+     * \param size : number of bytes, as provided to 'allocate'
+     * \return false if the memory doesn't belong to the arena
+     */
+    bool release (void* ptr, std::size_t size)
+    {
+        std::size_t k = chunkOf (ptr);
+        if (size>LARGE or k==MAX_CHUNKS)  { return false; }
+
+        // The last allocation of the owner thread can be given back (typical of a growing vector).
+        if (local().get()==this and depth_>0 and current_<nbChunks_ and
+            (char*)ptr + round(size) == chunks_[current_].load (std::memory_order_relaxed) + pos_)
+        {
+            pos_ -= round(size);
+        }
+
+        chunkLive_[k]--;
+        live_--;
+        return true;
+    }
+
+    /** Tell whether some memory belongs to the arena.
+     * \param ptr : the memory
+     * \return true if 'ptr' is inside one of the chunks
+     */
+    bool owns (const void* ptr) const  {  return chunkOf(ptr) < MAX_CHUNKS;  }
+
+    /** \return the number of allocations not released yet. */
+    std::size_t getNbLive() const { return live_; }
+
+    /** \return the number of chunks. */
+    std::size_t getNbChunks() const { return nbChunksPublished_; }
+
+private:
+
+    static std::size_t round (std::size_t size)  {  return (size + ALIGN - 1) & ~(ALIGN - 1);  }
+
+    static std::size_t chunkSize (std::size_t k)  {  return FIRST_CHUNK << (k<8 ? k : 8);  }
+
+    /** \return the index of the chunk holding 'ptr', MAX_CHUNKS if none. */
+    std::size_t chunkOf (const void* ptr) const
+    {
+        std::size_t nb = nbChunksPublished_.load (std::memory_order_acquire);
+        for (std::size_t k=0; k<nb; k++)
+        {
+            const char* chunk = chunks_[k].load (std::memory_order_acquire);
+            if ((const char*)ptr >= chunk and (const char*)ptr < chunk + chunkSize(k))  { return k; }
+        }
+        return MAX_CHUNKS;
+    }
+
+    /** \return the first chunk from 'k' having no live allocation (nbChunks_ if none). */
+    std::size_t firstFree (std::size_t k) const
+    {
+        while (k < nbChunks_ and chunkLive_[k] > 0)  { k++; }
+        return k;
+    }
+
+    /** Go to the first chunk from 'k' having no live allocation. */
+    void next (std::size_t k)
+    {
+        current_ = firstFree (k);
+        pos_     = 0;
+    }
+
+    void enter()
+    {
+        if (depth_++ == 0 and firstFree(0) <= current_)  {  next (0);  }
+    }
+
+    std::atomic<char*>       chunks_[MAX_CHUNKS]    = {};
+    std::atomic<std::size_t> chunkLive_[MAX_CHUNKS] = {};
+    std::atomic<std::size_t> nbChunksPublished_     = 0;
+    std::atomic<std::size_t> live_                  = 0;
+
+    // Only used by the owner thread.
+    std::size_t nbChunks_ = 0;
+    std::size_t current_  = 0;
+    std::size_t pos_      = 0;
+    std::size_t depth_    = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Allocator serving the allocations from the arena of the thread that created it (see Arena).
+ *
+ * An allocator created outside an arena scope, or used by another thread than the owner of its arena,
+ * falls back to the heap. A copied container gets a new allocator, so a result copied out of a task is
+ * not bound to the arena of the task.
+ */
+template<typename T>
+class ArenaAllocator
+{
+public:
+
+    using value_type = T;
+
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+    using is_always_equal                        = std::false_type;
+
+    ArenaAllocator() : arena_(Arena::current())  {}
+
+    template<typename U>
+    ArenaAllocator (const ArenaAllocator<U>& other) : arena_(other.arena_)  {}
+
+    ArenaAllocator select_on_container_copy_construction() const  {  return ArenaAllocator();  }
+
+    T* allocate (std::size_t n)
+    {
+        if (arena_ and alignof(T) <= Arena::ALIGN)
+        {
+            if (void* result = arena_->allocate (n*sizeof(T)))  { return static_cast<T*> (result); }
+        }
+        return std::allocator<T>().allocate (n);
+    }
+
+    void deallocate (T* ptr, std::size_t n)
+    {
+        if (arena_ and arena_->release (ptr, n*sizeof(T)))  { return; }
+        std::allocator<T>().deallocate (ptr, n);
+    }
+
+    template<typename U>
+    bool operator== (const ArenaAllocator<U>& other) const  {  return arena_ == other.arena_;  }
+
+private:
+    template<typename U> friend class ArenaAllocator;
+
+    std::shared_ptr<Arena> arena_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,461 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <bpl/utils/Topology.hpp>
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <optional>
+#include <variant>
+#include <memory>
+#include <atomic>
+#include <exception>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <charconv>
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+class ExecutorLease;
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Process-wide pool of worker threads.
+ *
+ * Instead of creating its own threads, each user (ArchMulticore, LauncherPool...) gets a lease on
+ * this single executor (see ExecutorLease), which bounds the number of its jobs running at the same
+ * time. So creating many launchers doesn't create any thread, and the machine is not oversubscribed.
+ *
+ * By default, there is one worker per logical CPU the process may run on and the workers are not
+ * pinned, so the process doesn't fight with the CPU affinity chosen by its host (taskset, MPI...).
+ * Pinning is opt-in: the workers are pinned on CPUs according to a placement policy (see
+ * bpl::Placement) set with 'configure' before the first use of the executor, or with the BPL_PLACEMENT
+ * (none, compact or scatter) environment variable. The number of workers can be set the same way
+ * (or with the BPL_NB_WORKERS environment variable, a positive number). An invalid value of these
+ * variables is reported on the error output and the default is used instead.
+ *
+ * A worker waiting for a sequence of jobs (see ExecutorLease::submit_sequence) executes the pending
+ * jobs of this sequence itself, so nested parallelism (a task running on a worker and waiting for
+ * other jobs) can't deadlock even when all the workers are waiting.
+ */
+class Executor
+{
+public:
+
+    /** \return the executor of the process (created at first call). */
+    static Executor& instance()
+    {
+        static Executor executor (settings());
+        return executor;
+    }
+
+    /** Configure the executor. This must be done before its first use.
+     * \param policy : placement policy of the workers
+     * \param nbWorkers : number of workers (0 means one per logical CPU)
+     * \return false if the executor is already running (the configuration is then ignored)
+     */
+    static bool configure (Placement policy, std::size_t nbWorkers=0)
+    {
+        auto& s = settings();
+        std::lock_guard<std::mutex> lock (s.mutex);
+        if (s.created)  { return false; }
+        s.policy    = policy;
+        s.nbWorkers = nbWorkers;
+        return true;
+    }
+
+    ~Executor()
+    {
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& w : workers_)  {  w.join();  }
+    }
+
+    Executor (const Executor&) = delete;
+    Executor& operator= (const Executor&) = delete;
+
+    /** \return the number of workers. */
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        return workers_.size();
+    }
+
+    /** Make sure that there are at least n workers. This is needed by users whose jobs may block
+     * (waiting for a PIM device for instance) and that need n of them to be in progress at the same time.
+     * \param n : the minimum number of workers
+     */
+    void reserve (std::size_t n)
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        while (workers_.size() < n)  {  spawn();  }
+    }
+
+    /** \return the topology the workers are placed on. */
+    const Topology& topology() const { return topology_; }
+
+    /** \return the placement policy of the workers. */
+    Placement placement() const { return policy_; }
+
+    /** \return the CPU the ith worker is pinned on (-1 if not pinned). */
+    int getWorkerCpu (std::size_t i) const
+    {
+        if (policy_==Placement::NONE or order_.empty())  { return -1; }
+        return order_[i % order_.size()].id;
+    }
+
+    /** The node is known only for a pinned worker: any other thread may be moved by the scheduler
+     * right after a sched_getcpu, so that its node would be a stale guess.
+     * \return the NUMA node of the calling thread if it is a pinned worker, -1 otherwise. */
+    int getCurrentNode() const
+    {
+        auto idx = getWorkerIndex();
+        int  cpu = idx ? getWorkerCpu (*idx) : -1;
+        return cpu<0 ? -1 : topology_.getNode (cpu);
+    }
+
+    /** \return the index of the calling worker, or nothing if the caller is not a worker of the executor. */
+    static std::optional<std::size_t> getWorkerIndex ()  {  return workerIndex();  }
+
+    /** Get a lease on the executor.
+     * \param concurrency : maximum number of jobs of the lease running at the same time
+     * \return the lease */
+    ExecutorLease lease (std::size_t concurrency);
+
+    /** Push a job to be executed by a worker. The job must not throw: the jobs submitted through
+     * a lease catch their exceptions, which are rethrown by the lease or the sequence they belong to.
+     * \param job : the job */
+    void push (std::function<void()>&& job)
+    {
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            queue_.push_back (std::move(job));
+        }
+        cv_.notify_one();
+    }
+
+private:
+
+    struct Settings
+    {
+        std::mutex  mutex;
+        Placement   policy    = Placement::NONE;
+        std::size_t nbWorkers = 0;
+        bool        created   = false;
+
+        Settings ()
+        {
+            if (const char* d = getenv ("BPL_PLACEMENT"))
+            {
+                     if (strcmp(d,"none")   ==0)  { policy = Placement::NONE;    }
+                else if (strcmp(d,"compact")==0)  { policy = Placement::COMPACT; }
+                else if (strcmp(d,"scatter")==0)  { policy = Placement::SCATTER; }
+                else  {  fprintf (stderr, "bpl: unknown BPL_PLACEMENT '%s' (none, compact or scatter), workers not pinned\n", d);  }
+            }
+            if (const char* d = getenv ("BPL_NB_WORKERS"))
+            {
+                long long   value = 0;
+                const char* end   = d + strlen(d);
+                auto [ptr,ec] = std::from_chars (d, end, value);
+                if (ec==std::errc() and ptr==end and value>0)  {  nbWorkers = value;  }
+                else  {  fprintf (stderr, "bpl: invalid BPL_NB_WORKERS '%s' (a positive number), one worker per CPU\n", d);  }
+            }
+        }
+    };
+
+    static Settings& settings()  {  static Settings s;  return s;  }
+
+    static std::optional<std::size_t>& workerIndex()  {  static thread_local std::optional<std::size_t> idx;  return idx;  }
+
+    Executor (Settings& s) : topology_ (Topology::read())
+    {
+        std::lock_guard<std::mutex> lock (s.mutex);
+        s.created = true;
+
+        policy_ = s.policy;
+        order_  = topology_.order (policy_);
+
+        std::size_t n = s.nbWorkers>0 ? s.nbWorkers : std::max (topology_.getNbCpus(), std::size_t(1));
+
+        std::lock_guard<std::mutex> lock2 (mutex_);
+        while (workers_.size() < n)  {  spawn();  }
+    }
+
+    /** Create a new worker (the mutex must be held). */
+    void spawn()
+    {
+        std::size_t idx = workers_.size();
+        int         cpu = getWorkerCpu (idx);
+
+        workers_.emplace_back ([this,idx,cpu]
+        {
+            workerIndex() = idx;
+            if (cpu>=0)  { Topology::pin (cpu); }
+
+            while (true)
+            {
+                std::function<void()> job;
+                {
+                    std::unique_lock<std::mutex> lock (mutex_);
+                    cv_.wait (lock, [this] { return stop_ or not queue_.empty(); });
+                    if (queue_.empty())  { return; }
+                    job = std::move (queue_.front());
+                    queue_.pop_front();
+                }
+                job();
+            }
+        });
+    }
+
+    Topology                          topology_;
+    Placement                         policy_ = Placement::NONE;
+    std::vector<CpuInfo>              order_;
+
+    mutable std::mutex                mutex_;
+    std::condition_variable           cv_;
+    std::deque<std::function<void()>> queue_;
+    std::vector<std::thread>          workers_;
+    bool                              stop_ = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+namespace impl
+{
+    /** \brief Jobs [first,last) of a sequence. The jobs are claimed one by one by the runners of the
+     * sequence (and by a worker waiting for the sequence), and their results are kept in order. */
+    template<typename R>
+    struct SequenceBase
+    {
+        using value_t = std::conditional_t<std::is_void_v<R>, std::monostate, std::optional<R>>;
+
+        SequenceBase (std::size_t n) : n_(n), remaining_(n), results_(n)  {}
+
+        virtual ~SequenceBase() {}
+
+        /** Execute the jobs not claimed yet. */
+        void process()
+        {
+            for (std::size_t i=next_++; i<n_; i=next_++)
+            {
+                try           {  execute (i);  }
+                catch (...)   {  std::lock_guard<std::mutex> lock (mutex_);  if (not error_)  { error_ = std::current_exception(); }  }
+
+                if (remaining_.fetch_sub(1) == 1)
+                {
+                    std::lock_guard<std::mutex> lock (mutex_);
+                    cv_.notify_all();
+                }
+            }
+        }
+
+        /** Wait for the end of all the jobs. */
+        void wait()
+        {
+            if (Executor::getWorkerIndex())  {  process();  }
+
+            std::unique_lock<std::mutex> lock (mutex_);
+            cv_.wait (lock, [this] { return remaining_.load()==0; });
+        }
+
+        virtual void execute (std::size_t i) = 0;
+
+        std::size_t              n_;
+        std::atomic<std::size_t> next_ {0};
+        std::atomic<std::size_t> remaining_;
+        std::vector<value_t>     results_;
+        std::exception_ptr       error_;
+        std::mutex               mutex_;
+        std::condition_variable  cv_;
+    };
+
+    template<typename T, typename F, typename R>
+    struct Sequence : SequenceBase<R>
+    {
+        Sequence (T first, T last, F fct)
+            : SequenceBase<R> (last>first ? std::size_t(last-first) : 0), first_(first), fct_(std::move(fct))  {}
+
+        void execute (std::size_t i) override
+        {
+            if constexpr (std::is_void_v<R>)  {  fct_ (T(first_+i));                        }
+            else                              {  this->results_[i].emplace (fct_ (T(first_+i)));  }
+        }
+
+        T first_;
+        F fct_;
+    };
+}
+
+/** \brief Future on the results of a sequence of jobs (see ExecutorLease::submit_sequence). */
+template<typename R>
+class SequenceFuture
+{
+public:
+
+    SequenceFuture (std::shared_ptr<impl::SequenceBase<R>> seq) : seq_(std::move(seq))  {}
+
+    /** Wait for the end of all the jobs. */
+    void wait()  {  seq_->wait();  }
+
+    /** Wait for the end of all the jobs and get their results.
+     * An exception thrown by a job is rethrown here.
+     * \return the results in the jobs order (nothing for void jobs) */
+    auto get()
+    {
+        seq_->wait();
+
+        if (seq_->error_)  {  std::rethrow_exception (seq_->error_);  }
+
+        if constexpr (not std::is_void_v<R>)
+        {
+            std::vector<R> result;
+            result.reserve (seq_->n_);
+            for (auto& x : seq_->results_)  {  result.push_back (std::move(*x));  }
+            return result;
+        }
+    }
+
+private:
+    std::shared_ptr<impl::SequenceBase<R>> seq_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Lease on the process-wide executor.
+ *
+ * A lease provides the part of the BS::thread_pool API used by the library (detach_task, submit_sequence,
+ * wait, get_thread_count), its jobs being executed by the workers of the executor with at most
+ * 'concurrency' of them running at the same time. A lease is a lightweight handle: copies share the
+ * same jobs.
+ */
+class ExecutorLease
+{
+public:
+
+    ExecutorLease () = default;
+
+    /** Constructor.
+     * \param executor : the executor the jobs are run by
+     * \param concurrency : maximum number of jobs running at the same time */
+    ExecutorLease (Executor& executor, std::size_t concurrency)
+        : state_ (std::make_shared<State> (executor, std::max (concurrency, std::size_t(1))))  {}
+
+    /** \return the maximum number of jobs of the lease that may actually run at the same time. */
+    std::size_t get_thread_count() const  {  return std::min (state_->concurrency, state_->executor.size());  }
+
+    /** \return the concurrency of the lease. */
+    std::size_t getConcurrency() const  {  return state_->concurrency;  }
+
+    /** Submit a job without waiting for its result.
+     * \param job : the job to be executed */
+    template<typename F>
+    void detach_task (F&& job)
+    {
+        std::function<void()> fct (std::forward<F>(job));
+
+        std::unique_lock<std::mutex> lock (state_->mutex);
+
+        if (state_->running < state_->concurrency)
+        {
+            state_->running++;
+            lock.unlock();
+            state_->executor.push ([state=state_, fct=std::move(fct)] () mutable {  run (state, std::move(fct));  });
+        }
+        else
+        {
+            state_->pending.push_back (std::move(fct));
+        }
+    }
+
+    /** Submit the jobs fct(i) for i in [first,last).
+     * \param first : first index
+     * \param last : last index (excluded)
+     * \param fct : the job
+     * \return a future on the results */
+    template<typename T, typename F, typename R = std::invoke_result_t<std::decay_t<F>,T>>
+    SequenceFuture<R> submit_sequence (T first, T last, F&& fct)
+    {
+        auto seq = std::make_shared<impl::Sequence<T,std::decay_t<F>,R>> (first, last, std::forward<F>(fct));
+
+        std::size_t nbRunners = std::min (seq->n_, state_->concurrency);
+
+        for (std::size_t i=0; i<nbRunners; i++)  {  detach_task ([seq] {  seq->process();  });  }
+
+        return SequenceFuture<R> (seq);
+    }
+
+    /** Wait for the end of all the jobs submitted through the lease.
+     * The first exception thrown by a job submitted with 'detach_task' since the last call is rethrown here.
+     * NOTE: this must not be called from a job of the same lease. */
+    void wait()
+    {
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock (state_->mutex);
+            state_->done.wait (lock, [this] { return state_->running==0 and state_->pending.empty(); });
+            std::swap (error, state_->error);
+        }
+        if (error)  {  std::rethrow_exception (error);  }
+    }
+
+private:
+
+    struct State
+    {
+        State (Executor& e, std::size_t c) : executor(e), concurrency(c)  {}
+
+        Executor&                         executor;
+        std::size_t                       concurrency;
+        std::mutex                        mutex;
+        std::condition_variable           done;
+        std::deque<std::function<void()>> pending;
+        std::size_t                       running = 0;
+        std::exception_ptr                error;
+    };
+
+    /** Execute a job, then the pending jobs of the lease until there is none. An exception thrown by a
+     * job is kept for 'wait', so it doesn't reach the worker (which would terminate the process). */
+    static void run (std::shared_ptr<State> state, std::function<void()> job)
+    {
+        while (true)
+        {
+            try          {  job();  }
+            catch (...)  {  std::lock_guard<std::mutex> lock (state->mutex);  if (not state->error)  { state->error = std::current_exception(); }  }
+
+            // The job (and what it holds) is released before the lease may be seen as idle.
+            job = nullptr;
+
+            std::lock_guard<std::mutex> lock (state->mutex);
+            if (state->pending.empty())
+            {
+                state->running--;
+                state->done.notify_all();
+                return;
+            }
+            job = std::move (state->pending.front());
+            state->pending.pop_front();
+        }
+    }
+
+    std::shared_ptr<State> state_;
+};
+
+inline ExecutorLease Executor::lease (std::size_t concurrency)  {  return ExecutorLease (*this, concurrency);  }
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <vector>
+#include <span>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+
+#include <unistd.h>
+#include <sys/syscall.h>
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+/** \brief Placement of the split arguments on the NUMA node of the thread processing them.
+ *   - NONE    : the split arguments are used where the caller allocated them
+ *   - COPY    : a slice having remote pages is copied into a buffer first touched by the thread
+ *   - MIGRATE : the pages of a slice are moved to the node of the thread (move_pages)
+ *
+ * COPY is worth it when a task reads its slice several times (all-vs-all sketch comparison for
+ * instance); MIGRATE when the same input is processed by several runs.
+ *
+ * The placement needs pinned workers (BPL_PLACEMENT or Executor::configure): the node of an
+ * unpinned thread is unknown, so that COPY and MIGRATE then leave the slices where they are.
+ */
+enum class NumaMode  {  NONE, COPY, MIGRATE  };
+
+namespace numa
+{
+    /** \return the size of a memory page. */
+    inline std::size_t pageSize()
+    {
+        static const std::size_t size = std::max (sysconf (_SC_PAGESIZE), 1L);
+        return size;
+    }
+
+    /** Get the NUMA node of each page holding the memory area [ptr,ptr+size).
+     * \param ptr : beginning of the area
+     * \param size : size of the area in bytes
+     * \return the nodes of the pages (-1 if unknown, e.g. page not touched yet or no NUMA support)
+     */
+    inline std::vector<int> getNodes (const void* ptr, std::size_t size)
+    {
+        std::vector<int> result;
+        if (size==0)  { return result; }
+
+        uintptr_t first = uintptr_t(ptr) / pageSize();
+        uintptr_t last  = (uintptr_t(ptr) + size - 1) / pageSize();
+
+        std::vector<void*> pages;
+        for (uintptr_t p=first; p<=last; p++)  {  pages.push_back ((void*) (p*pageSize()));  }
+
+        result.resize (pages.size(), -1);
+
+        // A null 'nodes' argument only queries the current node of each page.
+        if (syscall (SYS_move_pages, 0, pages.size(), pages.data(), nullptr, result.data(), 0) != 0)
+        {
+            std::fill (result.begin(), result.end(), -1);
+        }
+        for (auto& n : result)  {  if (n<0) { n = -1; }  }
+
+        return result;
+    }
+
+    /** Move the pages of the memory area [ptr,ptr+size) to a NUMA node. Only the pages fully inside
+     * the area are moved, so that the pages shared with a neighbour slice don't move back and forth.
+     * \param ptr : beginning of the area
+     * \param size : size of the area in bytes
+     * \param node : target node
+     * \return the number of bytes moved
+     */
+    inline std::size_t migrate (const void* ptr, std::size_t size, int node)
+    {
+        uintptr_t first = (uintptr_t(ptr) + pageSize() - 1) / pageSize();
+        uintptr_t last  = (uintptr_t(ptr) + size) / pageSize();
+        if (node<0 or last<=first)  { return 0; }
+
+        std::vector<void*> pages;
+        for (uintptr_t p=first; p<last; p++)  {  pages.push_back ((void*) (p*pageSize()));  }
+
+        std::vector<int> nodes  (pages.size(), node);
+        std::vector<int> status (pages.size(), -1);
+
+        if (syscall (SYS_move_pages, 0, pages.size(), pages.data(), nodes.data(), status.data(), 0) < 0)  { return 0; }
+
+        return std::count (status.begin(), status.end(), node) * pageSize();
+    }
+
+    /** \brief Bytes of split arguments read by the threads, according to where they are located. */
+    struct Counters
+    {
+        std::atomic<std::size_t> local    {0};
+        std::atomic<std::size_t> remote   {0};
+        std::atomic<std::size_t> copied   {0};
+        std::atomic<std::size_t> migrated {0};
+    };
+
+    /** \brief Places the slices given to a thread on the NUMA node of this thread (see NumaMode).
+     *
+     * The slices that are views (std::span) of trivially copyable items are checked: their bytes are
+     * counted as local or remote according to the node of their pages, then copied or migrated if some
+     * of them are remote. The other slices (std::vector for instance) are copies made by the thread
+     * itself, so they are already local. The copies live as long as the placer.
+     */
+    class Placer
+    {
+    public:
+
+        /** Constructor.
+         * \param mode : the placement mode
+         * \param node : the node of the calling thread (-1 if unknown)
+         * \param stats : counters to be updated */
+        Placer (NumaMode mode, int node, Counters& stats) : mode_(mode), node_(node), stats_(stats)  {}
+
+        /** Place a slice.
+         * \param x : the slice
+         * \return the slice to be used by the thread */
+        template<typename T>
+        T place (T x)  {  return x;  }
+
+        template<typename T>
+        requires (std::is_trivially_copyable_v<T>)
+        std::span<T> place (std::span<T> x)
+        {
+            std::size_t size = x.size_bytes();
+
+            if (mode_==NumaMode::NONE or node_<0 or size==0)  { return x; }
+
+            // Bytes of each page falling into the slice, the first and last pages being partial.
+            auto nodes = getNodes (x.data(), size);
+
+            uintptr_t begin = uintptr_t (x.data());
+            uintptr_t end   = begin + size;
+            uintptr_t page  = begin - begin % pageSize();
+
+            std::size_t remote = 0;
+            for (std::size_t i=0; i<nodes.size(); i++, page += pageSize())
+            {
+                std::size_t n = std::min (end, page + pageSize()) - std::max (begin, page);
+                if (nodes[i]>=0 and nodes[i]!=node_)  { remote += n; }
+            }
+
+            stats_.local  += size - remote;
+            stats_.remote += remote;
+
+            if (remote==0)  { return x; }
+
+            if (mode_==NumaMode::MIGRATE)
+            {
+                stats_.migrated += migrate (x.data(), size, node_);
+                return x;
+            }
+
+            // The buffer is first touched by the current thread, so its pages are allocated on its node.
+            using item_t = std::remove_const_t<T>;
+            std::shared_ptr<item_t[]> buffer (new item_t[x.size()]);
+            std::memcpy ((void*)buffer.get(), x.data(), size);
+            buffers_.push_back (buffer);
+
+            stats_.copied += size;
+
+            return std::span<T> (buffer.get(), x.size());
+        }
+
+    private:
+        NumaMode                           mode_;
+        int                                node_;
+        Counters&                          stats_;
+        std::vector<std::shared_ptr<void>> buffers_;
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,266 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <array>
+#include <utility>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+/** \brief Hardware performance counters of the calling thread: cycles, instructions, LLC misses and branch misses.
+ *
+ * The counters are read through the Linux perf_event_open interface. Each thread taking measures opens its own
+ * group of events the first time; the events of a group are scheduled together on the PMU, so the ratios between
+ * them (IPC for instance) are meaningful even when the kernel multiplexes the counters.
+ *
+ * The measures are activated by the BPL_PERF environment variable or by 'enable'. When the events can't be opened
+ * (not Linux, perf_event_paranoid too restrictive, no PMU in a virtual machine...), the measures are disabled and
+ * 'getStatus' tells why; an event that is not supported by the CPU is reported as 0.
+ */
+class PerfCounters
+{
+public:
+
+    /** Measured events. */
+    enum Event  {  CYCLES, INSTRUCTIONS, LLC_MISSES, BRANCH_MISSES, NB_EVENTS  };
+
+    /** Names of the events, used for the statistics tags. */
+    static constexpr std::array<const char*,NB_EVENTS> names = { "cycles", "instructions", "llc-misses", "branch-misses" };
+
+    /** \brief Values of the counters, accumulated over some measures. */
+    struct Values
+    {
+        std::array<uint64_t,NB_EVENTS> counts = {};
+
+        Values& operator+= (const Values& o)
+        {
+            for (std::size_t i=0; i<NB_EVENTS; i++)  {  counts[i] += o.counts[i];  }
+            return *this;
+        }
+
+        uint64_t operator[] (Event e) const  {  return counts[e];  }
+
+        /** \return the number of instructions per cycle. */
+        double getIPC() const  {  return counts[CYCLES]>0 ? double(counts[INSTRUCTIONS]) / counts[CYCLES] : 0.0;  }
+
+        /** \return the number of LLC misses per thousand instructions. */
+        double getMPKI() const  {  return counts[INSTRUCTIONS]>0 ? 1000.0 * counts[LLC_MISSES] / counts[INSTRUCTIONS] : 0.0;  }
+    };
+
+    /** \return true if the measures have been activated (even if the counters turned out to be unavailable). */
+    static bool enabled()  {  return enabled_.load (std::memory_order_relaxed);  }
+
+    /** \return true if the measures are active and the counters could be opened so far. */
+    static bool active()  {  return enabled() and not failed_.load (std::memory_order_relaxed);  }
+
+    /** Activate the measures from the program instead of the environment. */
+    static void enable()  {  enabled_ = true;  }
+
+    /** Stop taking measures. */
+    static void disable()  {  enabled_ = false;  }
+
+    /** \return true if the counters can be read by the calling thread (opening them if needed). */
+    static bool available()  {  return active() and local().open();  }
+
+    /** \return "ok", "disabled", or the reason why the counters are not available. */
+    static std::string getStatus()
+    {
+        if (not enabled())  { return "disabled"; }
+        std::lock_guard<std::mutex> lock (statusMutex_);
+        return status_;
+    }
+
+private:
+
+    /** Raw values read from a group, with the times used for scaling the multiplexed counters. */
+    struct Sample
+    {
+        uint64_t                       enabled = 0;
+        uint64_t                       running = 0;
+        std::array<uint64_t,NB_EVENTS> counts  = {};
+    };
+
+    /** \brief Group of events of a thread. */
+    class Group
+    {
+    public:
+
+        Group()  {  fds_.fill (-1);  position_.fill (-1);  }
+
+        ~Group()
+        {
+#if defined(__linux__)
+            for (int fd : fds_)  {  if (fd>=0)  { close (fd); }  }
+#endif
+        }
+
+        Group (const Group&) = delete;
+        Group& operator= (const Group&) = delete;
+
+        /** Open the events at the first call.
+         * \return true if the group could be opened */
+        bool open()
+        {
+            if (tried_)  { return opened_; }
+            tried_ = true;
+
+#if defined(__linux__)
+            static constexpr std::array<std::pair<uint32_t,uint64_t>,NB_EVENTS> events =
+            {{
+                { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES    },
+                { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS  },
+                { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+                { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+            }};
+
+            int nb = 0;
+            for (std::size_t e=0; e<NB_EVENTS; e++)
+            {
+                perf_event_attr attr;
+                memset (&attr, 0, sizeof(attr));
+                attr.size           = sizeof(attr);
+                attr.type           = events[e].first;
+                attr.config         = events[e].second;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv     = 1;
+                attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                // The calling thread, on any CPU; the first event is the leader of the group.
+                int fd = syscall (SYS_perf_event_open, &attr, 0, -1, e==0 ? -1 : fds_[0], 0);
+
+                if (fd < 0)
+                {
+                    // Without the leader, there is nothing to measure.
+                    if (e==0)  {  fail (std::string("unavailable: ") + strerror(errno));  return false;  }
+                    continue;
+                }
+
+                fds_[e]      = fd;
+                position_[e] = nb++;
+            }
+
+            opened_ = true;
+#else
+            fail ("unavailable: perf_event_open requires Linux");
+#endif
+            return opened_;
+        }
+
+        /** Read the current values of the group.
+         * \param sample : the read values
+         * \return false if the read failed */
+        bool read (Sample& sample) const
+        {
+#if defined(__linux__)
+            // Format of PERF_FORMAT_GROUP: nr, time_enabled, time_running, values[nr]
+            uint64_t buffer [3+NB_EVENTS];
+            if (::read (fds_[0], buffer, sizeof(buffer)) < ssize_t(3*sizeof(uint64_t)))  { return false; }
+
+            sample.enabled = buffer[1];
+            sample.running = buffer[2];
+            for (std::size_t e=0; e<NB_EVENTS; e++)
+            {
+                sample.counts[e] = position_[e]>=0 and uint64_t(position_[e])<buffer[0] ? buffer[3+position_[e]] : 0;
+            }
+            return true;
+#else
+            (void)sample;
+            return false;
+#endif
+        }
+
+    private:
+        std::array<int,NB_EVENTS> fds_;
+        std::array<int,NB_EVENTS> position_;
+        bool tried_  = false;
+        bool opened_ = false;
+    };
+
+public:
+
+    /** \brief Measure of the calling thread, from the creation of the object to its destruction. */
+    class Scope
+    {
+    public:
+
+        /** Constructor.
+         * \param values : values where the counts of the measure are added */
+        Scope (Values& values) : values_(values)
+        {
+            if (active() and local().open() and local().read (begin_))  {  group_ = &local();  }
+        }
+
+        ~Scope()
+        {
+            Sample end;
+            if (group_ and group_->read (end))  {  values_ += delta (begin_, end);  }
+        }
+
+        Scope (const Scope&) = delete;
+        Scope& operator= (const Scope&) = delete;
+
+    private:
+        Values& values_;
+        Group*  group_ = nullptr;
+        Sample  begin_;
+    };
+
+private:
+
+    /** \return the group of the calling thread (not opened yet at the first call). */
+    static Group& local()
+    {
+        thread_local Group group;
+        return group;
+    }
+
+    /** Disable the measures for all the threads, the counters being unavailable. */
+    static void fail (const std::string& reason)
+    {
+        std::lock_guard<std::mutex> lock (statusMutex_);
+        status_ = reason;
+        failed_ = true;
+    }
+
+    /** Difference between two samples, scaled if the group was not always on the PMU. */
+    static Values delta (const Sample& begin, const Sample& end)
+    {
+        uint64_t enabled = end.enabled - begin.enabled;
+        uint64_t running = end.running - begin.running;
+        double   scale   = running>0 and running<enabled ? double(enabled) / running : 1.0;
+
+        Values result;
+        for (std::size_t e=0; e<NB_EVENTS; e++)  {  result.counts[e] = uint64_t ((end.counts[e] - begin.counts[e]) * scale);  }
+        return result;
+    }
+
+    inline static std::atomic<bool> enabled_ { getenv ("BPL_PERF") != nullptr };
+    inline static std::atomic<bool> failed_  { false };
+    inline static std::mutex        statusMutex_;
+    inline static std::string       status_ = "ok";
+};
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
@@ -19,6 +19,9 @@ namespace bpl  {
 // https://stackoverflow.com/questions/7185437/is-there-a-range-class-in-c11-for-use-with-range-based-for-loops
 
 /** \brief class that allows to iterate an range of integers.
+ *
+ * The range can be strided: with a stride s, the iterated values are first, first+s, first+2s... (less than last).
+ * Such ranges are produced by the RAKE split of a range and don't need any memory.
  */
 class Range
 {
@@ -33,28 +36,31 @@ public:
 private:
 
     struct iterator  {
-        iterator (size_type idx) : idx_(idx)  {}
+        iterator (size_type idx, size_type stride=1) : idx_(idx), stride_(stride)  {}
         auto operator*() const { return idx_; }
-        iterator& operator++ () { ++idx_; return *this; }
+        iterator& operator++ () { idx_+=stride_; return *this; }
         bool operator!=(const iterator& other) const { return idx_!=other.idx_; }
         size_type idx_;
+        size_type stride_;
     };
 
 public:
 
     Range () = default;
 
-    Range (size_type first, size_type last) : bounds_(first,last)  {}
+    Range (size_type first, size_type last, size_type stride=1) : bounds_(first, last<first ? first : last), stride_(stride)  {}
 
-    auto begin () const { return iterator (bounds_.first); }
-    auto end   () const { return iterator (bounds_.second);  }
+    auto begin () const { return iterator (bounds_.first, stride_); }
+    auto end   () const { return iterator (bounds_.first + size()*stride_, stride_);  }
 
-    auto size() const { return bounds_.second - bounds_.first; }
+    size_type size() const { return (bounds_.second - bounds_.first + stride_ - 1) / stride_; }
 
-    auto first() const { return bounds_.first;  }
-    auto last () const { return bounds_.second; }
+    auto first () const { return bounds_.first;  }
+    auto last  () const { return bounds_.second; }
+    auto stride() const { return stride_; }
 
     std::pair<size_type,size_type> bounds_;
+    size_type stride_ = 1;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -68,11 +74,22 @@ struct SplitOperator<bpl::Range>
         size_t i0 = x.size() * (idx+0) / total;
         size_t i1 = x.size() * (idx+1) / total;
 
-        return bpl::Range (x.first() + i0, x.first() + i1);
+        return bpl::Range (x.first() + i0*x.stride(), x.first() + i1*x.stride(), x.stride());
     }
 
     static auto split_view (const bpl::Range& x, std::size_t idx, std::size_t total)
     {  return split (x, idx, total);  }
+
+    static auto split_interval (const bpl::Range& x, std::size_t i0, std::size_t i1)
+    {  return bpl::Range (x.first() + i0*x.stride(), x.first() + i1*x.stride(), x.stride());  }
+
+    // RAKE split: a strided view on the same range, so no copy at all.
+    static auto split_rake (const bpl::Range& x, std::size_t idx, std::size_t total)
+    {
+        return idx < x.size() ?
+            bpl::Range (x.first() + idx*x.stride(), x.last(), x.stride()*total) :
+            bpl::Range (x.last(), x.last(), x.stride()*total);
+    }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
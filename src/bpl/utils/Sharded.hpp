@@ -0,0 +1,244 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#ifndef DPU
+#include <array>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+/** \brief Default combination of the slots of a sharded accumulator: the sum. */
+template<typename T>
+struct AddOp
+{
+    T operator() (const T& a, const T& b) const  { return a+b; }
+};
+
+#ifndef DPU
+
+/** Size of a cache line; the per-thread slots are padded to this size in order to avoid false sharing. */
+inline constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+namespace impl
+{
+    /** \brief Indexes given to the threads updating sharded objects.
+     *
+     * A thread gets the smallest free index and gives it back when it exits, so the indexes stay
+     * small (ie. within the slots of the sharded objects) even when many short-lived threads are
+     * created one after the other.
+     */
+    class ShardIndexes
+    {
+    public:
+
+        // Never destroyed: threads (like the executor workers) may exit after the static objects destruction.
+        static ShardIndexes& instance()  {  static ShardIndexes* s = new ShardIndexes;  return *s;  }
+
+        std::size_t acquire()
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            auto it = std::find (used_.begin(), used_.end(), false);
+            if (it==used_.end())  {  it = used_.insert (used_.end(), false);  }
+            *it = true;
+            return it - used_.begin();
+        }
+
+        void release (std::size_t idx)
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            used_[idx] = false;
+        }
+
+    private:
+        std::mutex        mutex_;
+        std::vector<bool> used_;
+    };
+
+    /** \return a small index identifying the calling thread among the living threads that updated a sharded object. */
+    inline std::size_t getShardIndex()
+    {
+        struct Holder
+        {
+            std::size_t index = ShardIndexes::instance().acquire();
+            ~Holder()  {  ShardIndexes::instance().release (index);  }
+        };
+
+        thread_local Holder holder;
+        return holder.index;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Accumulator having one private copy per thread, combined when the value is needed.
+ *
+ * This is an alternative to a shared object protected by a mutex: each thread updates its own slot,
+ * padded to a cache line, without any synchronization; the slots are combined by 'value', which should
+ * be called once the updates are done (ie. after the run). The slot index of a thread is reused once the
+ * thread exits; the threads beyond the number of slots (running at the same time) share an extra slot
+ * protected by a mutex.
+ *
+ * \param T : type of the accumulated value
+ * \param OP : associative operation combining two values (sum by default)
+ */
+template<typename T, typename OP=AddOp<T>>
+class Sharded
+{
+public:
+
+    /** Constructor.
+     * \param init : initial value of each slot (neutral element of OP) */
+    Sharded (const T& init = T{})
+        : init_(init), slots_ (std::max (std::thread::hardware_concurrency(), 1u) + 8, Slot{init}), overflow_{init}  {}
+
+    /** Combine a value into the slot of the calling thread.
+     * \param x : the value to be combined */
+    template<typename U>
+    void add (const U& x)
+    {
+        update ([&] (T& value)  {  value = OP() (value, x);  });
+    }
+
+    /** Update in place the slot of the calling thread.
+     * \param fct : functor receiving a reference on the slot */
+    template<typename FCT>
+    void update (FCT fct)
+    {
+        std::size_t idx = impl::getShardIndex();
+        if (idx < slots_.size())  {  fct (slots_[idx].value);  }
+        else
+        {
+            std::lock_guard<std::mutex> lock (overflowMutex_);
+            fct (overflow_.value);
+        }
+    }
+
+    /** \return the combination of all the slots. */
+    T value() const
+    {
+        T result = overflow_.value;
+        for (auto const& slot : slots_)  {  result = OP() (result, slot.value);  }
+        return result;
+    }
+
+    /** Read each slot without combining them (for reading a part of the value only).
+     * \param fct : functor receiving a const reference on each slot */
+    template<typename FCT>
+    void visit (FCT fct) const
+    {
+        fct (overflow_.value);
+        for (auto const& slot : slots_)  {  fct (slot.value);  }
+    }
+
+    /** Reset all the slots to the initial value. */
+    void reset()
+    {
+        for (auto& slot : slots_)  {  slot.value = init_;  }
+        overflow_.value = init_;
+    }
+
+private:
+
+    struct alignas(CACHE_LINE_SIZE) Slot  {  T value;  };
+
+    T                 init_;
+    std::vector<Slot> slots_;
+    Slot              overflow_;
+    std::mutex        overflowMutex_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Lock free counter, alone on its cache line.
+ *
+ * Unlike Sharded, the current value is always available, which allows to distribute some work
+ * between the threads with 'fetch_add' (instead of a mutex protecting a shared index).
+ */
+template<typename T>
+class Counter
+{
+public:
+
+    Counter (T init = T{}) : value_(init)  {}
+
+    /** Add a value and return the previous one.
+     * \param n : the value to be added
+     * \return the value before the addition */
+    T fetch_add (T n=1)  {  return value_.fetch_add (n, std::memory_order_relaxed);  }
+
+    /** Add a value. */
+    void add (T n=1)  {  value_.fetch_add (n, std::memory_order_relaxed);  }
+
+    /** \return the current value. */
+    T value() const  {  return value_.load (std::memory_order_relaxed);  }
+
+    /** Set the value back to 0. */
+    void reset()  {  value_.store (T{}, std::memory_order_relaxed);  }
+
+private:
+    // The alignment also pads the object to a whole cache line.
+    alignas(CACHE_LINE_SIZE) std::atomic<T> value_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Histogram whose bins are sharded between the threads (see Sharded).
+ * \param N : number of bins
+ * \param T : type of the bins counters
+ */
+template<std::size_t N, typename T=uint64_t>
+class Histogram
+{
+public:
+
+    using bins_t = std::array<T,N>;
+
+    Histogram() : bins_ (bins_t{})  {}
+
+    /** Increment a bin.
+     * \param bin : index of the bin (less than N)
+     * \param n : value to be added to the bin */
+    void add (std::size_t bin, T n=1)  {  bins_.update ([&] (bins_t& bins)  {  bins[bin] += n;  });  }
+
+    /** \return the counters of all the bins, combined over the threads. */
+    bins_t value() const  {  return bins_.value();  }
+
+    /** \return the counter of one bin, combined over the threads. */
+    T operator[] (std::size_t bin) const  {  return value()[bin];  }
+
+    /** Set all the bins back to 0. */
+    void reset()  {  bins_.reset();  }
+
+private:
+
+    struct Op
+    {
+        bins_t operator() (bins_t a, const bins_t& b) const
+        {
+            for (std::size_t i=0; i<N; i++)  {  a[i] += b[i];  }
+            return a;
+        }
+    };
+
+    Sharded<bins_t,Op> bins_;
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
@@ -10,22 +10,258 @@
 
 #include <map>
 #include <string>
+#include <vector>
+#include <array>
+#include <mutex>
+#include <bit>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <optional>
 #include <bpl/utils/TimeUtils.hpp>
+#include <bpl/utils/Trace.hpp>
+#include <bpl/utils/Sharded.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace bpl  {
 ////////////////////////////////////////////////////////////////////////////////
 
+/** \brief Histogram of durations (in nanoseconds) with a bounded relative error, in the HDR histogram way.
+ *
+ * The values below 16 have their own bucket; above, each power of two is split into 16 buckets, so a value
+ * is known with a relative error less than 1/16. The recording is a few instructions, without allocation.
+ */
+class LatencyHistogram
+{
+public:
+
+    /** Number of buckets per power of two. */
+    static constexpr std::size_t SUB = 16;
+
+    /** Record a value.
+     * \param ns : the value (a duration in nanoseconds) */
+    void record (uint64_t ns)
+    {
+        counts_[index(ns)]++;
+        count_++;
+        sum_ += ns;
+        min_ = std::min (min_, ns);
+        max_ = std::max (max_, ns);
+    }
+
+    /** Add the values of another histogram.
+     * \param other : the other histogram */
+    void merge (const LatencyHistogram& other)
+    {
+        for (std::size_t i=0; i<counts_.size(); i++)  {  counts_[i] += other.counts_[i];  }
+        count_ += other.count_;
+        sum_   += other.sum_;
+        min_    = std::min (min_, other.min_);
+        max_    = std::max (max_, other.max_);
+    }
+
+    /** \return the number of recorded values. */
+    uint64_t getCount() const { return count_; }
+
+    /** \return the smallest recorded value (0 if none). */
+    uint64_t getMin() const { return count_>0 ? min_ : 0; }
+
+    /** \return the largest recorded value. */
+    uint64_t getMax() const { return max_; }
+
+    /** \return the mean of the recorded values. */
+    double getMean() const { return count_>0 ? double(sum_) / count_ : 0.0; }
+
+    /** Get a percentile of the recorded values.
+     * \param q : the percentile, between 0 and 1 (0.5 for the median, 0.99 for p99)
+     * \return the highest value of the bucket holding the percentile, bounded by the maximum */
+    uint64_t getPercentile (double q) const
+    {
+        if (count_==0)  { return 0; }
+
+        uint64_t rank = std::max (uint64_t(1), uint64_t (q * count_ + 0.5));
+        uint64_t cumul = 0;
+        for (std::size_t i=0; i<counts_.size(); i++)
+        {
+            cumul += counts_[i];
+            if (cumul >= rank)  {  return std::clamp (upper(i), getMin(), max_);  }
+        }
+        return max_;
+    }
+
+private:
+
+    static std::size_t index (uint64_t v)
+    {
+        if (v < SUB)  { return v; }
+        std::size_t shift = std::bit_width(v) - 5;
+        return (shift+1)*SUB + ((v >> shift) - SUB);
+    }
+
+    static uint64_t upper (std::size_t idx)
+    {
+        if (idx < SUB)  { return idx; }
+        std::size_t shift = idx/SUB - 1;
+        uint64_t    sub   = idx%SUB + SUB;
+        return ((sub+1) << shift) - 1;
+    }
+
+    std::array<uint64_t,(64-4+1)*SUB> counts_ = {};
+    uint64_t count_ = 0;
+    uint64_t sum_   = 0;
+    uint64_t min_   = std::numeric_limits<uint64_t>::max();
+    uint64_t max_   = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
 /** \brief Utility for gathering statistics information.
  *
  * This class provides an API for retrieving statistic information such as duration
  * or tracing calls number for some functions. This is useful for debugging/benchmarking
  * the library itself.
+ *
+ * The durations of the phases of a run are measured by 'timer'. A phase is identified by a prefix and a
+ * suffix (like "run" and "launch") interned once in a process-wide registry, so a measure doesn't build
+ * strings; each phase keeps the duration of its last measure ("prefix/once/suffix"), the cumulated
+ * durations ("prefix/cumul/suffix") and a histogram of the measures (see 'getHistogram').
+ * The measures are also events of the timeline when the tracing is active (see bpl::Trace).
+ *
+ * Only the measured phases are stored by an object. The timers are used by the thread owning the object,
+ * while 'record' may be called by any thread: the measures are then accumulated in a buffer of the
+ * calling thread (see bpl::Sharded), without lock, and merged when the statistics are read.
  */
 class Statistics
 {
 public:
 
+    /** \brief Name of a phase, usable as a template argument of 'timer'. */
+    template<std::size_t N>
+    struct PhaseName
+    {
+        constexpr PhaseName (const char (&s)[N])  {  std::copy_n (s, N, value);  }
+        char value[N];
+    };
+
+    /** \brief Phase interned in the process-wide registry. */
+    class Phase
+    {
+    public:
+        Phase (const std::string& prefix, const std::string& suffix) : id_ (registry().intern (prefix, suffix))  {}
+        std::size_t id() const { return id_; }
+    private:
+        std::size_t id_;
+    };
+
+    /** \brief Measure of a phase, from its creation (or 'start') to its destruction (or 'stop'). */
+    class PhaseTimer
+    {
+    public:
+        PhaseTimer (Statistics& stats, const Phase& phase) : stats_(stats), id_(phase.id())
+        {
+            stats_.getPhase(id_).once = 0;
+            start();
+        }
+
+        ~PhaseTimer()  {  stop();  }
+
+        PhaseTimer (const PhaseTimer&) = delete;
+        PhaseTimer& operator= (const PhaseTimer&) = delete;
+
+        void start()  {  started_ = true;  t0_ = timestamp_ns();  }
+
+        void stop()
+        {
+            if (started_)
+            {
+                started_ = false;
+                uint64_t t1 = timestamp_ns();
+                stats_.getPhase(id_).once += (t1-t0_) * 1e-9;
+                stats_.record (id_, t1-t0_);
+
+                if (Trace::enabled())
+                {
+                    auto [prefix,suffix] = registry().name (id_);
+                    Trace::instance().record (prefix + "/" + suffix, "phase", t0_, t1);
+                }
+            }
+        }
+
+    private:
+        Statistics& stats_;
+        std::size_t id_;
+        uint64_t    t0_      = 0;
+        bool        started_ = false;
+    };
+
+    /** Measure a phase whose name is known at compile time; the phase is interned at the first call only.
+     * \param PREFIX : prefix of the phase (for instance "run")
+     * \param SUFFIX : suffix of the phase (for instance "launch")
+     * \return a PhaseTimer object, measuring until its destruction
+     */
+    template<PhaseName PREFIX, PhaseName SUFFIX>
+    PhaseTimer timer ()
+    {
+        static const Phase phase (PREFIX.value, SUFFIX.value);
+        return PhaseTimer (*this, phase);
+    }
+
+    /** Measure a phase.
+     * \param phase : the phase
+     * \return a PhaseTimer object, measuring until its destruction
+     */
+    PhaseTimer timer (const Phase& phase)  {  return PhaseTimer (*this, phase);  }
+
+    /** Add a measure to the histogram and to the cumulated duration of a phase (for measures made
+     * elsewhere). This can be called by several threads at the same time; the measures must be done
+     * before the statistics are read.
+     * \param phase : the phase
+     * \param ns : duration in nanoseconds
+     */
+    void record (const Phase& phase, uint64_t ns)
+    {
+        std::call_once (*shardsOnce_, [this]  {  shards_ = std::make_unique<Sharded<PhaseMap,MergePhases>>();  });
+        shards_->update ([&] (PhaseMap& phases)  {  phases[phase.id()].record (ns);  });
+    }
+
+    Statistics () = default;
+
+    /** Copy: the measures recorded by all the threads are merged into the copy. */
+    Statistics (const Statistics& other)
+        : tags(other.tags), timings(other.timings), callsNb(other.callsNb), phases_(other.getPhases())  {}
+
+    Statistics& operator= (const Statistics& other)
+    {
+        if (this != &other)
+        {
+            tags       = other.tags;
+            timings    = other.timings;
+            callsNb    = other.callsNb;
+            phases_    = other.getPhases();
+            shards_.reset();
+            shardsOnce_ = std::make_unique<std::once_flag>();
+        }
+        return *this;
+    }
+
+    /** Get the histogram of the measures of a phase.
+     * \param prefix : prefix of the phase
+     * \param suffix : suffix of the phase
+     * \return the histogram (empty if the phase has not been measured)
+     */
+    LatencyHistogram getHistogram (const std::string& prefix, const std::string& suffix) const
+    {
+        auto id = registry().find (prefix, suffix);
+        if (not id)  { return LatencyHistogram{}; }
+
+        // Only the histograms of this phase are merged.
+        LatencyHistogram result;
+        visitPhase (*id, [&] (const PhaseData& phase)  {  result.merge (phase.histo);  });
+        return result;
+    }
+
     /** Produce a TimeStamp object for a given label.
      * \param label: the label associated to the timestamp
      * \param cumul: if true and if there is already a timing for the label, the same timing
@@ -52,14 +288,19 @@ public:
     }
 
     /** Produce two TimeStamp objects for a given labels with cumul and non cumul.
+     * The phase is interned at each call: in a loop, intern it once (see Phase) and use the other overload.
      * \param prefix: prefix added to the label
      * \param suffix: the actual label
      */
     auto produceCumulTimestamp (const char* prefix, const char* suffix)  {
-        std::string nocumul = std::string(prefix) + "/once/"  + std::string(suffix);
-        std::string   cumul = std::string(prefix) + "/cumul/" + std::string(suffix);
-        timings[nocumul]={};
-        return DualTimeStamp (TimeStamp (timings[nocumul]), TimeStamp (timings[cumul]));
+        return timer (Phase (prefix, suffix));
+    }
+
+    /** Produce two TimeStamp objects for an interned phase with cumul and non cumul.
+     * \param phase: the phase
+     */
+    auto produceCumulTimestamp (const Phase& phase)  {
+        return timer (phase);
     }
 
     void dump(bool force=false) const
@@ -81,6 +322,18 @@ public:
                 printf ("       %-35s: %7.4f\n", entry.first.c_str(), entry.second);
             }
 
+            auto phases = getPhases();
+            printf ("   phases : %ld\n", phases.size());
+            for (auto const& [id,phase] : phases)
+            {
+                auto const& h = phase.histo;
+                if (h.getCount()==0)  { continue; }
+                auto [prefix,suffix] = registry().name (id);
+                printf ("       %-35s: n=%-6ld p50=%9.3f us  p99=%9.3f us  max=%9.3f us\n", (prefix + "/" + suffix).c_str(),
+                    h.getCount(), h.getPercentile(0.5)*1e-3, h.getPercentile(0.99)*1e-3, h.getMax()*1e-3
+                );
+            }
+
             printf ("   tags   : %ld\n", tags.size());
             for (const auto& entry: tags)
             {
@@ -90,15 +343,46 @@ public:
         }
     }
 
-    /** Return the map of timings. */
-    const std::map<std::string, float>&  getTimings () const { return timings; }
+    /** Return the map of timings (the phases being provided as "prefix/once/suffix" and "prefix/cumul/suffix"). */
+    std::map<std::string, double> getTimings () const
+    {
+        // The durations of the phases are gathered without their histograms.
+        std::map<std::size_t,PhaseValue> values;
+        auto add = [&] (const PhaseMap& phases)  {  for (auto const& [id,phase] : phases)  {  values[id] += phase;  }  };
+        add (phases_);
+        if (shards_)  {  shards_->visit (add);  }
+
+        auto result = timings;
+        for (auto const& [id,value] : values)
+        {
+            if (not value.used)  { continue; }
+            auto [prefix,suffix] = registry().name (id);
+            result[prefix + "/once/"  + suffix] = value.once;
+            result[prefix + "/cumul/" + suffix] = value.cumul;
+        }
+        return result;
+    }
 
     /** Return the map of calls number. */
     const std::map<std::string, size_t>& getCallsNb () const { return callsNb; }
 
     /** Return the timing for a given key. */
-    float getTiming(const std::string& key) const
+    double getTiming(const std::string& key) const
     {
+        // A phase ("prefix/once/suffix" or "prefix/cumul/suffix") is read alone, without merging the measures.
+        for (const std::string field : {"/once/", "/cumul/"})
+        {
+            auto pos = key.find (field);
+            if (pos == std::string::npos)  { continue; }
+
+            auto id = registry().find (key.substr (0, pos), key.substr (pos + field.size()));
+            if (not id)  { continue; }
+
+            PhaseValue value;
+            visitPhase (*id, [&] (const PhaseData& phase)  {  value += phase;  });
+            if (value.used)  {  return field=="/once/" ? value.once : value.cumul;  }
+        }
+
         auto lookup = timings.find (key);
         return lookup != timings.end() ? lookup->second : 0.0;
     }
@@ -121,6 +405,12 @@ public:
     /** Set the timing for a given key. */
     void addTiming (const std::string& key, double value) { timings[key] = value; }
 
+    /** Remove the timings whose key starts with a given prefix. */
+    void removeTimings (const std::string& prefix)
+    {
+        std::erase_if (timings, [&] (auto const& entry)  {  return entry.first.starts_with (prefix);  });
+    }
+
     /** Get the value of a given key. . */
     auto const& getTag (const std::string& key) const { return tags.at(key); }
 
@@ -134,8 +424,145 @@ public:
 private:
 
     std::map<std::string, std::string>  tags;
-    std::map<std::string, float>  timings;
+    std::map<std::string, double> timings;
     std::map<std::string, size_t> callsNb;
+
+    struct PhaseData
+    {
+        double           once  = 0;
+        double           cumul = 0;
+        bool             used  = false;
+        LatencyHistogram histo;
+
+        void record (uint64_t ns)
+        {
+            cumul += ns * 1e-9;
+            used   = true;
+            histo.record (ns);
+        }
+    };
+
+    /** \brief Measures of the measured phases, by identifier.
+     *
+     * The identifiers are small (see Registry), so a flat table gives the slot of a phase with an index
+     * instead of a map lookup; only the measured phases have a slot (a histogram is not that small).
+     */
+    class PhaseMap
+    {
+    public:
+        PhaseData& operator[] (std::size_t id)
+        {
+            if (id >= slots_.size())  {  slots_.resize (id+1, NONE);  }
+            if (slots_[id] == NONE)   {  slots_[id] = data_.size();  data_.emplace_back (id, PhaseData{});  }
+            return data_[slots_[id]].second;
+        }
+
+        const PhaseData* find (std::size_t id) const
+        {
+            return id < slots_.size() and slots_[id] != NONE ? &data_[slots_[id]].second : nullptr;
+        }
+
+        using const_iterator = std::vector<std::pair<std::size_t,PhaseData>>::const_iterator;
+
+        const_iterator begin() const { return data_.begin(); }
+        const_iterator end  () const { return data_.end();   }
+        std::size_t    size () const { return data_.size();  }
+
+    private:
+        static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t>                         slots_;
+        std::vector<std::pair<std::size_t,PhaseData>> data_;
+    };
+
+    struct MergePhases
+    {
+        PhaseMap operator() (PhaseMap a, const PhaseMap& b) const
+        {
+            for (auto const& [id,phase] : b)
+            {
+                auto& x = a[id];
+                x.cumul += phase.cumul;
+                x.used   = x.used or phase.used;
+                x.histo.merge (phase.histo);
+            }
+            return a;
+        }
+    };
+
+    /** Measures of the timers. */
+    PhaseMap phases_;
+
+    /** Measures of 'record', one buffer per thread (created at the first call). */
+    std::unique_ptr<Sharded<PhaseMap,MergePhases>> shards_;
+    std::unique_ptr<std::once_flag>                shardsOnce_ = std::make_unique<std::once_flag>();
+
+    PhaseData& getPhase (std::size_t id)  {  return phases_[id];  }
+
+    void record (std::size_t id, uint64_t ns)  {  getPhase(id).record (ns);  }
+
+    /** Durations of a phase, gathered from the measures of the timers and of 'record'. */
+    struct PhaseValue
+    {
+        double once  = 0;
+        double cumul = 0;
+        bool   used  = false;
+
+        PhaseValue& operator+= (const PhaseData& phase)
+        {
+            once  += phase.once;
+            cumul += phase.cumul;
+            used   = used or phase.used;
+            return *this;
+        }
+    };
+
+    /** Call a functor on the measures of a phase made by the timers and by each thread calling 'record'. */
+    template<typename FCT>
+    void visitPhase (std::size_t id, FCT fct) const
+    {
+        if (auto phase = phases_.find (id))  {  fct (*phase);  }
+        if (shards_)  {  shards_->visit ([&] (const PhaseMap& phases)  {  if (auto phase = phases.find (id))  { fct (*phase); }  });  }
+    }
+
+    /** \return the measures of the timers merged with the ones of 'record'. */
+    PhaseMap getPhases () const
+    {
+        return shards_ ? MergePhases() (phases_, shards_->value()) : phases_;
+    }
+
+    /** \brief Names of the phases, an identifier being given to each (prefix,suffix) pair. */
+    class Registry
+    {
+    public:
+        std::size_t intern (const std::string& prefix, const std::string& suffix)
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            auto [it,inserted] = ids_.try_emplace (std::make_pair (prefix, suffix), names_.size());
+            if (inserted)  {  names_.push_back (it->first);  }
+            return it->second;
+        }
+
+        std::optional<std::size_t> find (const std::string& prefix, const std::string& suffix)
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            auto lookup = ids_.find (std::make_pair (prefix, suffix));
+            if (lookup == ids_.end())  { return std::nullopt; }
+            return lookup->second;
+        }
+
+        std::pair<std::string,std::string> name (std::size_t id)
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            return names_[id];
+        }
+
+    private:
+        std::mutex mutex_;
+        std::map<std::pair<std::string,std::string>, std::size_t> ids_;
+        std::vector<std::pair<std::string,std::string>> names_;
+    };
+
+    static Registry& registry()  {  static Registry r;  return r;  }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
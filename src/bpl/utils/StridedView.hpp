@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+/** \brief Non owning view on the items of a contiguous buffer taken with a constant stride modulo its size.
+ *
+ * The kth item of the view is data[(start + k*stride) mod n]. It is what the RAKE split (start=idx,
+ * stride=total, no wrap around) and the RAND split (a slice of the affine permutation used by
+ * impl::SplitPermutation) of a vector or a span produce, so these parts need no copy.
+ *
+ * The view provides size(), operator[] and forward iteration. A task parameter that requires contiguous
+ * items (std::vector, std::span...) can't be built from it: the architecture then gathers the items
+ * with 'to_vector' (see ArchMulticore::prepare).
+ */
+template<typename T>
+class strided_view
+{
+public:
+
+    using value_type      = std::remove_cv_t<T>;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using pointer         = T*;
+
+    struct iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = strided_view::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = T&;
+        using pointer           = T*;
+
+        T*        data_   = nullptr;
+        size_type n_      = 0;
+        size_type stride_ = 0;
+        size_type pos_    = 0;
+        size_type k_      = 0;
+
+        reference operator*  () const  {  return data_[pos_];   }
+        pointer   operator-> () const  {  return data_ + pos_;  }
+
+        iterator& operator++ ()
+        {
+            k_++;
+            pos_ += stride_;
+            if (pos_ >= n_)  {  pos_ -= n_;  }
+            return *this;
+        }
+
+        iterator operator++ (int)  {  iterator tmp = *this;  ++(*this);  return tmp;  }
+
+        bool operator== (const iterator& other) const  {  return k_ == other.k_;  }
+        bool operator!= (const iterator& other) const  {  return k_ != other.k_;  }
+    };
+
+    strided_view () = default;
+
+    /** Constructor.
+     * \param data : the buffer
+     * \param n : number of items of the buffer (the indexes are taken modulo n)
+     * \param start : index of the first item of the view
+     * \param stride : distance between two consecutive items of the view
+     * \param count : number of items of the view
+     */
+    strided_view (T* data, size_type n, size_type start, size_type stride, size_type count)
+        : data_(data), n_(n), start_(n>0 ? start%n : 0), stride_(n>0 ? stride%n : 0), count_(n>0 ? count : 0)  {}
+
+    size_type size () const  {  return count_;     }
+    bool      empty() const  {  return count_==0;  }
+
+    reference operator[] (size_type k) const  {  return data_[(start_ + mulmod(k,stride_)) % n_];  }
+
+    iterator begin() const  {  return iterator {data_, n_, stride_, start_, 0     };  }
+    iterator end  () const  {  return iterator {data_, n_, stride_, start_, count_};  }
+
+    /** Gather the items of the view into a vector.
+     * \return the gathered items
+     */
+    std::vector<value_type> to_vector () const  {  return std::vector<value_type> (begin(), end());  }
+
+private:
+
+    T*        data_   = nullptr;
+    size_type n_      = 0;
+    size_type start_  = 0;
+    size_type stride_ = 0;
+    size_type count_  = 0;
+
+    size_type mulmod (size_type x, size_type y) const
+    {
+#if defined(__SIZEOF_INT128__)
+        return (unsigned __int128)x * y % n_;
+#else
+        return uint64_t(x) * y % n_;   // no 128 bits integers (e.g. DPU) -> domain supposed to be < 2^32
+#endif
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Type trait telling whether a type is a strided_view. */
+template<typename T>  struct is_strided_view                   : std::false_type {};
+template<typename T>  struct is_strided_view<strided_view<T>>  : std::true_type  {};
+
+template<typename T>  inline constexpr bool is_strided_view_v = is_strided_view<std::decay_t<T>>::value;
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
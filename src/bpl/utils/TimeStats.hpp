@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <vector>
+
+#ifndef DPU
+#include <array>
+#include <tuple>
+#include <limits>
+#include <algorithm>
+#include <string>
+#include <sstream>
+#include <cstdio>
+#include <bpl/utils/Statistics.hpp>
+#endif
+
+#define WITH_STATS_TIME_MEDIAN 1
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+/** \brief Generic class that gathers time information during a tasklet execution (or a job of the multicore architecture).
+ */
+template<typename T>
+struct TimeStatsValues
+{
+    /** Total time of the tasklet. */
+    T all         = T();
+    /** Time taken by a tasklet for the unserialization of the incoming arguments from the host. */
+    T unserialize = T();
+    /** Time taken by a tasklet for splitting the arguments encapsulated by a call to 'split' at host call site. */
+    T split       = T();
+    /** Time taken by a tasklet for the running the task, ie. call to operator(). */
+    T exec        = T();
+    /** Time taken by a tasklet for preparing the result for the host. */
+    T result      = T();
+
+    /** Increase the fields values of the current object with the fields values of an input object. */
+    template<typename T1>
+    TimeStatsValues<T>& operator+= (const TimeStatsValues<T1>& o)
+    {
+        all         += o.all;
+        unserialize += o.unserialize;
+        split       += o.split;
+        exec        += o.exec;
+        result      += o.result;
+        return *this;
+    }
+};
+
+/** \brief Class that gathers time information during a tasklet execution.
+ *
+ * Uses a specific type for gathering the information.
+ * \see TimeStatsValues
+ */
+struct TimeStats : TimeStatsValues<uint64_t>
+{
+    using value_type = uint64_t;
+
+    static auto minmax (const std::vector<TimeStats>& entries)
+    {
+        TimeStats m;
+        TimeStats M;
+
+        m.all = std::numeric_limits<value_type>::max();
+        M.all = 0;
+
+        std::vector<value_type> alls;
+        for (const auto& x : entries)
+        {
+            alls.push_back (x.all);
+            if (x.all < m.all)  { m = x; }
+            if (x.all > M.all)  { M = x; }
+        }
+
+#ifdef WITH_STATS_TIME_MEDIAN
+        std::sort(alls.begin(), alls.end());
+#endif
+        std::array<value_type,32> quantiles = {};
+
+        if (not alls.empty())
+        {
+            size_t idx=0; for (auto& x : quantiles) { x = alls[idx*alls.size()/quantiles.size()]; idx++; }
+            quantiles.back() = alls.back();
+        }
+
+        return std::make_tuple (m,M,quantiles);
+    }
+
+    static auto mean (const std::vector<TimeStats>& entries)
+    {
+        TimeStatsValues<uint64_t> res;
+
+        for (const auto& x : entries)  {  res += x;  }
+
+        return TimeStatsValues<double>
+        {
+            double(res.unserialize) / double(res.all),
+            double(res.split)       / double(res.all),
+            double(res.exec)        / double(res.all),
+            double(res.result)      / double(res.all),
+            double(res.all)         / double(entries.size())
+        };
+    }
+};
+
+#ifndef DPU
+
+/** Add to some statistics the distribution of the times of the process units of a run:
+ *   - prefix/max and prefix/min: the slowest and fastest process units, with their breakdown per phase
+ *   - prefix/quantiles: 32 quantiles of the times of the process units
+ * \param stats : the statistics to be completed
+ * \param prefix : prefix of the tags
+ * \param entries : times of the process units
+ * \param clocks_per_sec : number of time units per second
+ */
+inline void addTimeStatsTags (Statistics& stats, const std::string& prefix, const std::vector<TimeStats>& entries, double clocks_per_sec)
+{
+    char buffer[512];
+
+    auto [min,max,quantiles] = TimeStats::minmax (entries);
+
+    auto dump = [&] (const std::string& key, auto value)
+    {
+        double all = value.unserialize + value.split + value.exec + value.result;
+
+        snprintf (buffer, sizeof(buffer), "time: %.4f sec  (%.4f + %.4f + %.4f + %.4f)  [percent]  unserialize: %5.2f   split: %5.2f  exec:%5.2f  result: %5.2f",
+            double(all)               / clocks_per_sec,
+            double(value.unserialize) / clocks_per_sec,
+            double(value.split)       / clocks_per_sec,
+            double(value.exec)        / clocks_per_sec,
+            double(value.result)      / clocks_per_sec,
+            100.0*value.unserialize   / all,
+            100.0*value.split         / all,
+            100.0*value.exec          / all,
+            100.0*value.result        / all
+        );
+        stats.addTag (prefix + key, buffer);
+    };
+
+    dump ("/max", max);
+    dump ("/min", min);
+
+    std::stringstream ss;
+    snprintf (buffer, sizeof(buffer), "[%2ld]", entries.size());
+    ss << buffer;
+
+    for (auto x : quantiles)
+    {
+        snprintf (buffer, sizeof(buffer), " %.3f", (double)x / clocks_per_sec);
+        ss << buffer;
+    }
+
+    stats.addTag (prefix + "/quantiles", ss.str());
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace bpl  {
@@ -21,12 +22,21 @@ static inline auto  timestamp()
     return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
+/** Returns a timestamp (in nanoseconds) of a monotonic clock, to be used for measuring durations.
+ */
+static inline uint64_t timestamp_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /** \brief Utility for computing duration between two execution points.
  *
  * The variable that holds the duration is given as a reference to the constructor; a timestamp t0 is then generated.
  *
- * When the destructor is invoked, a timestamp t1 is generated and the referred variable is set to be t1-t0.
+ * When the destructor is invoked, a timestamp t1 is generated and t1-t0 (in seconds, or in nanoseconds for an
+ * integer variable) is added to the referred variable.
+ * The timestamps come from a monotonic clock with a nanosecond resolution.
  *
  * It remains possible to explicitely call 'start' and 'stop'.
  */
@@ -37,7 +47,12 @@ public:
     /** Constructor.
      * \param ref: a reference on the variable that will hold the duration.
      */
-    TimeStamp(float& ref) : ref_(ref)  {  start();  }
+    TimeStamp(double& ref) : ref_(&ref)  {  start();  }
+
+    /** Constructor.
+     * \param ref: a reference on the variable that will hold the duration, in nanoseconds.
+     */
+    TimeStamp(uint64_t& ref) : refNs_(&ref)  {  start();  }
 
     /** Destructor.  The final timestamp is generated and the duration computed. */
     ~TimeStamp()  { stop();  }
@@ -46,7 +61,7 @@ public:
     void start ()
     {
         started_ = true;
-        t0_ = t1_ = timestamp();
+        t0_ = t1_ = timestamp_ns();
     }
 
     /** Generates the final timestamp. */
@@ -55,13 +70,15 @@ public:
         if (started_)
         {
             started_ = false;
-            t1_ = timestamp() ;
-            ref_ += (t1_ - t0_) / 1000.0 / 1000.0;
+            t1_ = timestamp_ns() ;
+            if (ref_)  {  *ref_   += (t1_ - t0_) * 1e-9;  }
+            else       {  *refNs_ += (t1_ - t0_);         }
         }
     }
 
 private:
-    float& ref_;
+    double*   ref_   = nullptr;
+    uint64_t* refNs_ = nullptr;
     uint64_t  t0_ = 0;
     uint64_t  t1_ = 0;
     bool started_ = false;
@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#ifndef DPU
+#include <vector>
+#include <queue>
+#include <utility>
+#include <stdexcept>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+/** \brief Item of a top-K list: identifier of an object and its score.
+ *
+ * The items are ranked by decreasing score, then by increasing identifier, so that a top-K list is
+ * fully determined by the scores (which allows to merge partial lists in a deterministic way).
+ * An empty item (identifier EMPTY) is used for completing a list having less than K items.
+ */
+template<typename ID=uint32_t, typename SCORE=uint16_t>
+struct TopKItem
+{
+    using id_t    = ID;
+    using score_t = SCORE;
+
+    static constexpr ID EMPTY = ~ID(0);
+
+    ID    id    = EMPTY;
+    SCORE score = 0;
+
+    /** \return true if the item is an empty one. */
+    bool empty() const { return id==EMPTY; }
+
+    /** \return true if the item 'a' is ranked before the item 'b'. */
+    static bool better (const TopKItem& a, const TopKItem& b)
+    {
+        return a.score > b.score or (a.score==b.score and a.id < b.id);
+    }
+
+    bool operator== (const TopKItem& other) const { return id==other.id and score==other.score; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Bounded list of the K best items inserted.
+ *
+ * The items are held in a binary heap whose root is the worst kept item, so an item that is not
+ * better than the root is rejected with a single comparison, which is the common case once the
+ * heap is full. The storage is a fixed size array (no allocation, usable on PIM side).
+ *
+ * \param ITEM : type of the items (see TopKItem)
+ * \param KMAX : maximum value of K
+ */
+template<typename ITEM, std::size_t KMAX>
+class TopK
+{
+public:
+
+    using item_t = ITEM;
+
+    /** Constructor. A value of k greater than KMAX is clamped to KMAX, so a caller that can't guarantee
+     * k<=KMAX must use 'capacity' as the number of items per list (or reject such a k).
+     * \param k : number of items to be kept (at most KMAX) */
+    TopK (std::size_t k) : k_ (k<KMAX ? k : KMAX)  {}
+
+    /** \return the number of items to be kept. */
+    std::size_t capacity() const { return k_; }
+
+    /** \return the number of items currently kept. */
+    std::size_t size() const { return n_; }
+
+    /** Insert an item.
+     * \param item : the item to be inserted */
+    void insert (const item_t& item)
+    {
+        if (n_ < k_)
+        {
+            // Sift up of the new leaf.
+            std::size_t i = n_++;
+            while (i>0 and item_t::better (items_[(i-1)/2], item))  {  items_[i] = items_[(i-1)/2];  i = (i-1)/2;  }
+            items_[i] = item;
+        }
+        else if (k_>0 and item_t::better (item, items_[0]))
+        {
+            siftDown (0, item, n_);
+        }
+    }
+
+    /** Append the kept items (best first), completed with empty items up to K, and clear the list.
+     * \param out : the container the items are appended to (through 'push_back') */
+    template<typename OUT>
+    void flush (OUT& out)
+    {
+        // Heap sort: the worst item goes at the end of the array, so the array is finally sorted best first.
+        for (std::size_t n=n_; n>1; n--)
+        {
+            item_t last = items_[n-1];
+            items_[n-1] = items_[0];
+            siftDown (0, last, n-1);
+        }
+
+        for (std::size_t i=0; i<n_; i++)  {  out.push_back (items_[i]);  }
+        for (std::size_t i=n_; i<k_; i++)  {  out.push_back (item_t{});   }
+
+        n_ = 0;
+    }
+
+private:
+
+    item_t      items_[KMAX];
+    std::size_t k_;
+    std::size_t n_ = 0;
+
+    /** Put 'item' at the position 'i' of the heap made of the 'n' first items and restore the heap property. */
+    void siftDown (std::size_t i, const item_t& item, std::size_t n)
+    {
+        while (true)
+        {
+            std::size_t c = 2*i+1;
+            if (c >= n)  { break; }
+            if (c+1<n and item_t::better (items_[c], items_[c+1]))  { c++; }
+            if (not item_t::better (item, items_[c]))  { break; }
+            items_[i] = items_[c];
+            i = c;
+        }
+        items_[i] = item;
+    }
+};
+
+#ifndef DPU
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Merge partial top-K lists.
+ *
+ * Each part holds K items (best first, possibly completed with empty items) for each query, the
+ * queries being in the same order in all the parts. The lists of a query are merged with a k-way
+ * merge (heap of cursors on the parts), which stops as soon as K items are found.
+ *
+ * An exception is thrown if the parts don't hold the same number of items, or if this number is not
+ * a multiple of k (for instance when k is greater than the KMAX of the TopK lists of the parts).
+ *
+ * \param parts : iterable over the parts (one per process unit for instance)
+ * \param k : number of items per query
+ * \return the K best items of each query (best first, completed with empty items)
+ */
+template<typename PARTS>
+auto mergeTopK (const PARTS& parts, std::size_t k)
+{
+    using part_t = std::decay_t<decltype(*std::begin(parts))>;
+    using item_t = std::decay_t<decltype(*std::begin(std::declval<part_t&>()))>;
+
+    std::vector<const part_t*> lists;
+    for (auto const& part : parts)  {  lists.push_back (&part);  }
+
+    std::size_t nbQueries = (lists.empty() or k==0) ? 0 : std::begin(parts)->size() / k;
+
+    for (auto list : lists)
+    {
+        if (list->size() != nbQueries*k)  {  throw std::runtime_error ("top-K parts must hold K items per query");  }
+    }
+
+    std::vector<item_t> result;
+    result.reserve (nbQueries*k);
+
+    // Cursor on a list: (index of the part, index of the item in the K items of the query).
+    using cursor_t = std::pair<std::size_t,std::size_t>;
+
+    for (std::size_t q=0; q<nbQueries; q++)
+    {
+        const std::size_t offset = q*k;
+
+        auto worse = [&] (const cursor_t& a, const cursor_t& b)
+        {
+            return item_t::better ((*lists[b.first])[offset+b.second], (*lists[a.first])[offset+a.second]);
+        };
+
+        std::priority_queue<cursor_t,std::vector<cursor_t>,decltype(worse)> heap (worse);
+
+        for (std::size_t p=0; p<lists.size(); p++)
+        {
+            if (not (*lists[p])[offset].empty())  {  heap.push ({p,0});  }
+        }
+
+        std::size_t n = 0;
+        while (n<k and not heap.empty())
+        {
+            auto [p,i] = heap.top();
+            heap.pop();
+
+            result.push_back ((*lists[p])[offset+i]);
+            n++;
+
+            if (i+1<k and not (*lists[p])[offset+i+1].empty())  {  heap.push ({p,i+1});  }
+        }
+
+        for ( ; n<k; n++)  {  result.push_back (item_t{});  }
+    }
+
+    return result;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
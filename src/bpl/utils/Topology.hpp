@@ -0,0 +1,250 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <tuple>
+#include <thread>
+#include <cstring>
+
+#include <sched.h>
+#include <pthread.h>
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+/** \brief Placement policy of the threads over the logical CPUs.
+ *   - NONE    : the threads are not pinned
+ *   - COMPACT : the threads fill the SMT siblings of a core, then the cores of a socket, then the sockets
+ *   - SCATTER : the threads are spread over the sockets and the physical cores first, SMT siblings last
+ */
+enum class Placement  {  NONE, COMPACT, SCATTER  };
+
+/** \brief Logical CPU of the machine. */
+struct CpuInfo
+{
+    /** Identifier of the logical CPU (as used by sched_setaffinity). */
+    int id      = 0;
+    /** Socket (physical package) of the CPU. */
+    int socket  = 0;
+    /** Physical core of the CPU (unique for the whole machine). */
+    int core    = 0;
+    /** Rank of the CPU among the SMT siblings of its core. */
+    int smt     = 0;
+    /** NUMA node of the CPU. */
+    int node    = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/** \brief Topology of the logical CPUs the process is allowed to run on.
+ *
+ * The information is read from /sys/devices/system/cpu (sockets, cores, SMT siblings) and from
+ * /sys/devices/system/node (NUMA nodes), and restricted to the affinity mask of the process.
+ * If /sys can't be read, each CPU is considered as a physical core of a single socket.
+ */
+class Topology
+{
+public:
+
+    /** Read the topology of the current machine.
+     * \param root : root of the CPUs description (tests may provide a fake tree)
+     * \param affinity : if true, only the CPUs of the affinity mask of the process are kept
+     * \return the topology
+     */
+    static Topology read (const std::string& root = "/sys/devices/system/cpu", bool affinity = true)
+    {
+        Topology result;
+
+        std::vector<int> ids;
+
+        cpu_set_t mask;
+        CPU_ZERO (&mask);
+        bool hasMask = affinity and sched_getaffinity (0, sizeof(mask), &mask) == 0;
+
+        for (int id : parseList (readLine (root + "/online")))
+        {
+            if (not hasMask or (id < CPU_SETSIZE and CPU_ISSET (id, &mask)))  {  ids.push_back (id);  }
+        }
+
+        if (ids.empty())
+        {
+            for (int id=0; id < int(std::max (std::thread::hardware_concurrency(), 1u)); id++)  {  ids.push_back (id);  }
+        }
+
+        for (int id : ids)
+        {
+            std::string dir = root + "/cpu" + std::to_string(id);
+
+            CpuInfo cpu;
+            cpu.id     = id;
+            cpu.socket = std::max (toInt (readLine (dir + "/topology/physical_package_id"), 0), 0);
+            cpu.core   = toInt (readLine (dir + "/topology/core_id"), id);
+
+            // The SMT rank is the position of the CPU in the list of its siblings.
+            auto siblings = parseList (readLine (dir + "/topology/thread_siblings_list"));
+            auto it = std::find (siblings.begin(), siblings.end(), id);
+            cpu.smt = it!=siblings.end() ? int (it - siblings.begin()) : 0;
+
+            result.cpus_.push_back (cpu);
+        }
+
+        // The NUMA nodes are described in a sibling directory of the CPUs one.
+        for (int node : parseList (readLine (root + "/../node/online")))
+        {
+            for (int id : parseList (readLine (root + "/../node/node" + std::to_string(node) + "/cpulist")))
+            {
+                for (auto& cpu : result.cpus_)  {  if (cpu.id==id)  { cpu.node = node; }  }
+            }
+        }
+
+        // core_id is only unique inside a socket -> we renumber the cores for the whole machine.
+        std::vector<std::pair<int,int>> cores;
+        for (auto const& cpu : result.cpus_)  {  cores.push_back ({cpu.socket, cpu.core});  }
+        std::sort (cores.begin(), cores.end());
+        cores.erase (std::unique (cores.begin(), cores.end()), cores.end());
+
+        for (auto& cpu : result.cpus_)
+        {
+            cpu.core = int (std::lower_bound (cores.begin(), cores.end(), std::make_pair (cpu.socket, cpu.core)) - cores.begin());
+        }
+
+        return result;
+    }
+
+    /** \return the logical CPUs. */
+    const std::vector<CpuInfo>& cpus() const { return cpus_; }
+
+    /** \return the number of logical CPUs. */
+    std::size_t getNbCpus() const { return cpus_.size(); }
+
+    /** \return the number of physical cores. */
+    std::size_t getNbCores() const { return count ([] (auto const& c) { return c.core;   }); }
+
+    /** \return the number of sockets. */
+    std::size_t getNbSockets() const { return count ([] (auto const& c) { return c.socket; }); }
+
+    /** \return the number of NUMA nodes. */
+    std::size_t getNbNodes() const { return count ([] (auto const& c) { return c.node;   }); }
+
+    /** Get the NUMA node of a logical CPU.
+     * \param cpu : the CPU identifier
+     * \return the node (-1 if the CPU is unknown) */
+    int getNode (int cpu) const
+    {
+        for (auto const& c : cpus_)  {  if (c.id==cpu)  { return c.node; }  }
+        return -1;
+    }
+
+    /** Order in which the logical CPUs are given to successive threads for a placement policy.
+     * \param policy : the placement policy
+     * \return the CPUs, the ith thread being pinned on the item i modulo the number of CPUs.
+     */
+    std::vector<CpuInfo> order (Placement policy) const
+    {
+        auto result = cpus_;
+
+        if (policy==Placement::COMPACT)
+        {
+            std::sort (result.begin(), result.end(), [] (auto const& a, auto const& b)
+            {
+                return std::tie (a.socket, a.core, a.smt, a.id) < std::tie (b.socket, b.core, b.smt, b.id);
+            });
+        }
+        else if (policy==Placement::SCATTER)
+        {
+            // Rank of each core inside its socket, so that the sockets are used in a round robin way.
+            std::vector<std::pair<int,int>> cores;
+            for (auto const& cpu : cpus_)  {  cores.push_back ({cpu.socket, cpu.core});  }
+            std::sort (cores.begin(), cores.end());
+            cores.erase (std::unique (cores.begin(), cores.end()), cores.end());
+
+            auto rank = [&] (const CpuInfo& c)
+            {
+                auto first = std::lower_bound (cores.begin(), cores.end(), std::make_pair (c.socket, -1));
+                auto it    = std::lower_bound (cores.begin(), cores.end(), std::make_pair (c.socket, c.core));
+                return int (it - first);
+            };
+
+            std::sort (result.begin(), result.end(), [&] (auto const& a, auto const& b)
+            {
+                int ra = rank(a);
+                int rb = rank(b);
+                return std::tie (a.smt, ra, a.socket, a.id) < std::tie (b.smt, rb, b.socket, b.id);
+            });
+        }
+
+        return result;
+    }
+
+    /** Pin the calling thread on a logical CPU.
+     * \param cpu : the CPU identifier
+     * \return true if the thread could be pinned
+     */
+    static bool pin (int cpu)
+    {
+        if (cpu<0 or cpu>=CPU_SETSIZE)  { return false; }
+        cpu_set_t set;
+        CPU_ZERO (&set);
+        CPU_SET  (cpu, &set);
+        return pthread_setaffinity_np (pthread_self(), sizeof(set), &set) == 0;
+    }
+
+private:
+
+    std::vector<CpuInfo> cpus_;
+
+    template<typename FCT>
+    std::size_t count (FCT fct) const
+    {
+        std::vector<int> v;
+        for (auto const& c : cpus_)  {  v.push_back (fct(c));  }
+        std::sort (v.begin(), v.end());
+        return std::unique (v.begin(), v.end()) - v.begin();
+    }
+
+    static std::string readLine (const std::string& path)
+    {
+        std::ifstream is (path);
+        std::string line;
+        std::getline (is, line);
+        return line;
+    }
+
+    static int toInt (const std::string& s, int defaultValue)
+    {
+        try               {  return s.empty() ? defaultValue : std::stoi (s);  }
+        catch (...)       {  return defaultValue;                             }
+    }
+
+    /** Parse a CPU list like "0-3,8,10-11". */
+    static std::vector<int> parseList (const std::string& s)
+    {
+        std::vector<int> result;
+        std::stringstream ss (s);
+        std::string item;
+        while (std::getline (ss, item, ','))
+        {
+            auto dash = item.find ('-');
+            int a = toInt (item.substr (0, dash), -1);
+            int b = dash==std::string::npos ? a : toInt (item.substr (dash+1), -1);
+            for (int i=a; i>=0 and i<=b; i++)  {  result.push_back (i);  }
+        }
+        return result;
+    }
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,314 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <bpl/utils/TimeUtils.hpp>
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+/** \brief Timeline of the execution, written as a Chrome trace file (readable by chrome://tracing or Perfetto).
+ *
+ * The tracing is activated by the BPL_TRACE environment variable, whose value is the path of the file
+ * to be written (bpl_trace.json if the value is empty or "1"). The file is written at the end of the
+ * process (if some events were recorded), or by 'flush'. When the variable is not set, recording an event is a test on a boolean.
+ *
+ * Each event is a phase with a begin and an end, attached to a process ('HOST' for the host threads,
+ * 'DPU' for the tasklets of the DPUs) and to a thread of this process (a worker of the executor or a
+ * tasklet); it may refer a run (see 'newRun') and the process unit it was executed for.
+ *
+ * A thread keeps at most 'getMaxEventsPerThread' events (the next ones are dropped and counted, see
+ * 'getNbDropped'), so that a long traced process doesn't exhaust the memory; 'clear' gives the room back
+ * and releases the events of the threads that exited.
+ */
+class Trace
+{
+public:
+
+    /** Processes of the timeline. */
+    enum Process  {  HOST=1, DPU=2  };
+
+    /** \brief Event of the timeline. */
+    struct Event
+    {
+        std::string name;
+        const char* category = "";
+        uint64_t    begin    = 0;
+        uint64_t    end      = 0;
+        int         pid      = HOST;
+        uint64_t    tid      = 0;
+        int64_t     run      = -1;
+        int64_t     unit     = -1;
+    };
+
+    /** \return true if the tracing is active. */
+    static bool enabled()  {  return enabled_.load (std::memory_order_relaxed);  }
+
+    /** Activate the tracing from the program instead of the environment.
+     * \param path : path of the trace file */
+    static void enable (const std::string& path)
+    {
+        auto& trace = instance();
+        {
+            std::lock_guard<std::mutex> lock (trace.mutex_);
+            trace.path_ = path;
+        }
+        if (not enabled_.exchange (true))  {  std::atexit (flushAtExit);  }
+    }
+
+    /** Stop recording events (the events recorded so far are kept). */
+    static void disable()  {  enabled_ = false;  }
+
+    /** Remove the events recorded so far, and the buffers of the threads that exited. */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        // A buffer only referred by the trace belongs to a thread that exited.
+        std::erase_if (buffers_, [] (auto const& buffer)  {  return buffer.use_count() == 1;  });
+
+        for (auto const& buffer : buffers_)
+        {
+            std::lock_guard<std::mutex> lockBuffer (buffer->mutex);
+            buffer->events.clear();
+            buffer->events.shrink_to_fit();
+            buffer->dropped = 0;
+        }
+    }
+
+    /** \return the maximum number of events kept for a thread. */
+    static std::size_t getMaxEventsPerThread()  {  return maxEvents_.load (std::memory_order_relaxed);  }
+
+    /** Set the maximum number of events kept for a thread.
+     * \param nb : the maximum number of events */
+    static void setMaxEventsPerThread (std::size_t nb)  {  maxEvents_ = nb;  }
+
+    /** \return the trace of the process. */
+    static Trace& instance()
+    {
+        // Never destroyed, so that threads still running at exit may record events safely.
+        static Trace* trace = new Trace();
+        return *trace;
+    }
+
+    /** \return an identifier for a new run (-1 if the tracing is not active). */
+    static int64_t newRun()
+    {
+        static std::atomic<int64_t> nb {0};
+        return enabled() ? int64_t(nb++) : -1;
+    }
+
+    /** \return an identifier of the calling thread in the HOST process (the threads are numbered
+     * in the order of their first call, so two threads never share an identifier). */
+    static uint64_t getThreadId()
+    {
+        static std::atomic<uint64_t> nb {0};
+        thread_local uint64_t id = nb++;
+        return id;
+    }
+
+    /** Record an event (dropped if the calling thread already has the maximum number of events).
+     * \param event : the event */
+    void record (Event&& event)
+    {
+        auto& buffer = local();
+        std::lock_guard<std::mutex> lock (buffer->mutex);
+        if (buffer->events.size() < getMaxEventsPerThread())  {  buffer->events.push_back (std::move(event));  }
+        else                                                  {  buffer->dropped++;                            }
+    }
+
+    /** Record an event of the calling thread of the HOST process.
+     * \param name : name of the event
+     * \param category : category of the event
+     * \param begin : begin timestamp (see bpl::timestamp_ns)
+     * \param end : end timestamp
+     * \param run : run the event belongs to (-1 if none)
+     * \param unit : process unit the event belongs to (-1 if none)
+     */
+    void record (std::string_view name, const char* category, uint64_t begin, uint64_t end, int64_t run=-1, int64_t unit=-1)
+    {
+        record (Event { std::string(name), category, begin, end, HOST, getThreadId(), run, unit });
+    }
+
+    /** \brief Event of the calling thread, from the creation of the object to its destruction. */
+    class Scope
+    {
+    public:
+        Scope (const char* name, const char* category, int64_t run=-1, int64_t unit=-1)
+            : name_(name), category_(category), run_(run), unit_(unit), begin_ (enabled() ? timestamp_ns() : 0)  {}
+
+        ~Scope()
+        {
+            if (enabled())  {  instance().record (name_, category_, begin_, timestamp_ns(), run_, unit_);  }
+        }
+
+        Scope (const Scope&) = delete;
+        Scope& operator= (const Scope&) = delete;
+
+    private:
+        const char* name_;
+        const char* category_;
+        int64_t     run_;
+        int64_t     unit_;
+        uint64_t    begin_;
+    };
+
+    /** Write the events recorded so far to the trace file.
+     * \return false if the file couldn't be written */
+    bool flush()
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        FILE* file = fopen (path_.c_str(), "w");
+        if (file==nullptr)  { return false; }
+
+        fprintf (file, "{\"traceEvents\":[\n");
+        fprintf (file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"HOST\"}},\n", HOST);
+        fprintf (file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"DPU\"}}",    DPU);
+
+        for (auto const& buffer : buffers_)
+        {
+            std::lock_guard<std::mutex> lockBuffer (buffer->mutex);
+            for (auto const& e : buffer->events)
+            {
+                fprintf (file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%lu,\"args\":{",
+                    escape(e.name).c_str(), e.category,
+                    (int64_t(e.begin) - int64_t(origin_)) * 1e-3, (int64_t(e.end) - int64_t(e.begin)) * 1e-3,
+                    e.pid, (unsigned long)e.tid
+                );
+                const char* sep = "";
+                if (e.run >=0)  {  fprintf (file, "\"run\":%ld",  (long)e.run);   sep = ",";  }
+                if (e.unit>=0)  {  fprintf (file, "%s\"unit\":%ld", sep, (long)e.unit);  }
+                fprintf (file, "}}");
+            }
+        }
+
+        fprintf (file, "\n]}\n");
+        fclose (file);
+
+        if (std::size_t dropped = getNbDroppedLocked())
+        {
+            fprintf (stderr, "bpl: %zu trace events dropped (more than %zu events for a thread)\n", dropped, getMaxEventsPerThread());
+        }
+        return true;
+    }
+
+    /** \return the path of the trace file. */
+    std::string getPath()
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        return path_;
+    }
+
+    /** \return the number of events dropped since the last 'clear' (see 'getMaxEventsPerThread'). */
+    std::size_t getNbDropped()
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        return getNbDroppedLocked();
+    }
+
+    /** \return the number of events recorded so far. */
+    std::size_t getNbEvents()
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        std::size_t nb = 0;
+        for (auto const& buffer : buffers_)
+        {
+            std::lock_guard<std::mutex> lockBuffer (buffer->mutex);
+            nb += buffer->events.size();
+        }
+        return nb;
+    }
+
+private:
+
+    /** Events of a thread; the mutex is only contended by 'flush'. */
+    struct Buffer
+    {
+        std::mutex         mutex;
+        std::vector<Event> events;
+        std::size_t        dropped = 0;
+    };
+
+    /** \return the number of dropped events (the mutex must be held). */
+    std::size_t getNbDroppedLocked()
+    {
+        std::size_t nb = 0;
+        for (auto const& buffer : buffers_)
+        {
+            std::lock_guard<std::mutex> lockBuffer (buffer->mutex);
+            nb += buffer->dropped;
+        }
+        return nb;
+    }
+
+    Trace()
+    {
+        const char* d = getenv ("BPL_TRACE");
+        path_ = (d==nullptr or *d==0 or std::string_view(d)=="1") ? "bpl_trace.json" : d;
+
+        if (enabled())  {  std::atexit (flushAtExit);  }
+    }
+
+    static void flushAtExit()
+    {
+        if (instance().getNbEvents() > 0)  {  instance().flush();  }
+    }
+
+    /** \return the buffer of the calling thread (created and registered at the first call). */
+    const std::shared_ptr<Buffer>& local()
+    {
+        thread_local std::shared_ptr<Buffer> buffer = [this]
+        {
+            auto result = std::make_shared<Buffer>();
+            std::lock_guard<std::mutex> lock (mutex_);
+            buffers_.push_back (result);
+            return result;
+        } ();
+        return buffer;
+    }
+
+    static std::string escape (const std::string& s)
+    {
+        std::string result;
+        for (char c : s)
+        {
+            if (c=='"' or c=='\\')  {  result += '\\';  }
+            if (c>=0 and c<0x20)    {  continue;        }
+            result += c;
+        }
+        return result;
+    }
+
+    inline static std::atomic<bool> enabled_ { getenv ("BPL_TRACE") != nullptr };
+
+    inline static std::atomic<std::size_t> maxEvents_ { std::size_t(1) << 18 };
+
+    /** Beginning of the timeline. */
+    inline static const uint64_t origin_ = timestamp_ns();
+
+    std::string                          path_;
+    std::mutex                           mutex_;
+    std::vector<std::shared_ptr<Buffer>> buffers_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,201 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics 
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <bpl/utils/split.hpp>
+#include <bpl/utils/Range.hpp>
+#include <algorithm>
+#include <vector>
+#include <memory>
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+namespace impl
+{
+    // A pair [first,second) is not iterable, so we have to iterate its integers explicitly.
+    template<typename T>              inline constexpr bool is_pair_v                  = false;
+    template<typename A, typename B>  inline constexpr bool is_pair_v<std::pair<A,B>> = true;
+}
+
+/** \brief Object associating a cost to each item of a splitable object.
+ *
+ * The default split of an object balances the number of items of each part. When the cost of an item
+ * depends on the item itself (length of a sequence, size of a sketch...), some parts may be much more
+ * expensive than others. A Weighted object holds the prefix sums of the items costs, so that the parts
+ * computed by SplitOperator<Weighted<TYPE>> have a balanced total cost.
+ *
+ * Such an object can be used wherever the proxied object can be, ie. 'split<LEVEL>(weighted(v,cost))'
+ * provides to the task the same type as 'split<LEVEL>(v)' would do.
+ *
+ * NOTE: the split type must provide a 'split_interval' method in its SplitOperator specialization.
+ *
+ * An object provided as a lvalue is referenced, so it must live while the Weighted object is used. An
+ * object provided as a rvalue (a temporary range for instance) is moved into the Weighted object, which
+ * then owns it (the copies of the Weighted object share it).
+ *
+ * \param TYPE : the type of the proxied object
+ */
+template<typename TYPE>
+class Weighted
+{
+public:
+
+    using type   = std::decay_t<TYPE>;
+    using cost_t = uint64_t;
+
+    /** Constructor from a cost function.
+     * \param t : the object we want to keep a reference on.
+     * \param cost : function returning the cost of an item of the object.
+     */
+    template<typename COST>
+    requires (not std::is_convertible_v<COST,std::vector<cost_t>>)
+    Weighted (const type& t, COST&& cost) : t_(&t)  {  init (cost);  }
+
+    /** Constructor from a cost function, the object being owned by the Weighted object.
+     * \param t : the object to be moved.
+     * \param cost : function returning the cost of an item of the object.
+     */
+    template<typename COST>
+    requires (not std::is_convertible_v<COST,std::vector<cost_t>>)
+    Weighted (type&& t, COST&& cost) : owned_(std::make_shared<const type>(std::move(t))), t_(owned_.get())  {  init (cost);  }
+
+    /** Constructor from the prefix sums of the items costs.
+     * \param t : the object we want to keep a reference on.
+     * \param prefix : prefix sums of the costs, ie. prefix[i] is the cost of the first i items (so prefix[0]==0)
+     */
+    Weighted (const type& t, std::vector<cost_t> prefix) : t_(&t), prefix_(std::move(prefix))
+    {
+        if (prefix_.empty())  {  prefix_.push_back (0);  }
+    }
+
+    /** Constructor from the prefix sums of the items costs, the object being owned by the Weighted object.
+     * \param t : the object to be moved.
+     * \param prefix : prefix sums of the costs, ie. prefix[i] is the cost of the first i items (so prefix[0]==0)
+     */
+    Weighted (type&& t, std::vector<cost_t> prefix)
+        : owned_(std::make_shared<const type>(std::move(t))), t_(owned_.get()), prefix_(std::move(prefix))
+    {
+        if (prefix_.empty())  {  prefix_.push_back (0);  }
+    }
+
+    /** Cast operator
+     * \return the reference on the proxied object
+     */
+    operator const type& () const { return *t_; }
+
+    /** Number of items of the object. */
+    std::size_t size() const { return prefix_.size()-1; }
+
+    /** Total cost of the object. */
+    cost_t cost() const { return prefix_.back(); }
+
+    /** Cost of the items [i0,i1). */
+    cost_t cost (std::size_t i0, std::size_t i1) const { return prefix_[i1] - prefix_[i0]; }
+
+    /** Compute the interval of items of the ith part of the object, with a total cost as close as
+     * possible to cost()/total.
+     * \param idx : the index of the partition to be computed
+     * \param total : total number of partitions
+     * \return the interval [i0,i1) of items
+     */
+    std::pair<std::size_t,std::size_t> bounds (std::size_t idx, std::size_t total) const
+    {
+        return { boundary(idx,total), boundary(idx+1,total) };
+    }
+
+private:
+
+    template<typename COST>
+    void init (COST& cost)
+    {
+        prefix_.push_back (0);
+
+        auto add = [&] (auto&& item)  {  prefix_.push_back (prefix_.back() + cost_t(cost(item)));  };
+
+        if constexpr (impl::is_pair_v<type>)  {  for (auto i=t_->first; i<t_->second; i++)  {  add(i);     }  }
+        else                                  {  for (auto&& item : *t_)                   {  add(item);  }  }
+    }
+
+    /** First item of the ith part. The boundaries are computed independently from each other, so they
+     * must be increasing with idx: we take the prefix sum the closest to the target cost.
+     */
+    std::size_t boundary (std::size_t idx, std::size_t total) const
+    {
+        std::size_t n = size();
+
+        if (idx>=total)  { return n; }
+
+        // No cost at all -> we fall back to the default split.
+        if (cost()==0)  {  return n * idx / total;  }
+
+        cost_t target = cost_t (
+#if defined(__SIZEOF_INT128__)
+            (unsigned __int128)cost() * idx / total
+#else
+            (long double)cost() * idx / total
+#endif
+        );
+
+        std::size_t k = std::lower_bound (prefix_.begin(), prefix_.end(), target) - prefix_.begin();
+
+        if (k>0 and target-prefix_[k-1] < prefix_[k]-target)  { k--; }
+
+        return std::min (k,n);
+    }
+
+    std::shared_ptr<const type> owned_;
+    const type*                 t_ = nullptr;
+    std::vector<cost_t>         prefix_;
+};
+
+/** Build a Weighted object.
+ * \param t : the object to be split (moved into the Weighted object if it is a rvalue)
+ * \param cost : either a function returning the cost of an item, or the prefix sums of the items costs.
+ * \return the Weighted object
+ */
+template<typename TYPE, typename COST>
+auto weighted (TYPE&& t, COST&& cost)
+{
+    return Weighted<std::decay_t<TYPE>> (std::forward<TYPE>(t), std::forward<COST>(cost));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/** \brief Template specialization of SplitOperator for the Weighted type.
+ * \see bpl::SplitOperator. */
+template<typename TYPE>
+struct SplitOperator<bpl::Weighted<TYPE>>
+{
+    using operator_t = SplitOperator<std::decay_t<TYPE>>;
+
+    static auto split (const bpl::Weighted<TYPE>& x, std::size_t idx, std::size_t total)
+    {
+        auto [i0,i1] = x.bounds (idx, total);
+        return operator_t::split_interval ((const TYPE&)x, i0, i1);
+    }
+
+    static auto split_view (const bpl::Weighted<TYPE>& x, std::size_t idx, std::size_t total)
+    {
+        auto [i0,i1] = x.bounds (idx, total);
+
+        if constexpr (requires { operator_t::split_interval_view ((const TYPE&)x, std::size_t(0), std::size_t(0)); })
+        {
+            return operator_t::split_interval_view ((const TYPE&)x, i0, i1);
+        }
+        else
+        {
+            return operator_t::split_interval ((const TYPE&)x, i0, i1);
+        }
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
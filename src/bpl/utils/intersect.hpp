@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <firstinclude.hpp>
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BPL_INTERSECT_X86
+#include <immintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+namespace bpl  {
+////////////////////////////////////////////////////////////////////////////////
+
+/** \brief Instruction sets that can be used by the SIMD kernels, by increasing order. */
+enum class SimdLevel  {  SCALAR=0, SSE=1, AVX2=2, AVX512=3  };
+
+/** \brief Type of a kernel counting the common items of two sorted arrays. */
+using intersect_fct_t = std::size_t (*) (const uint32_t* a, std::size_t na, const uint32_t* b, std::size_t nb);
+
+namespace impl
+{
+    /** Scalar reference: merge of the two arrays (without unpredictable branches). */
+    inline std::size_t intersect_count_scalar (const uint32_t* a, std::size_t na, const uint32_t* b, std::size_t nb, std::size_t i=0, std::size_t j=0)
+    {
+        std::size_t count = 0;
+        while (i<na and j<nb)
+        {
+            uint32_t x = a[i];
+            uint32_t y = b[j];
+            count += x==y;
+            i     += x<=y;
+            j     += y<=x;
+        }
+        return count;
+    }
+
+#ifdef BPL_INTERSECT_X86
+
+    // The SIMD kernels compare a block of a with all the rotations of a block of b (so each item of the
+    // block of a is compared to each item of the block of b), then go to the next block of the array
+    // whose current block has the lowest maximum (or both). The remaining items are handled by the
+    // scalar merge.
+
+    __attribute__((target("sse2")))
+    inline std::size_t intersect_count_sse (const uint32_t* a, std::size_t na, const uint32_t* b, std::size_t nb)
+    {
+        std::size_t count = 0;
+        std::size_t i=0, j=0;
+
+        while (i+4<=na and j+4<=nb)
+        {
+            __m128i va = _mm_loadu_si128 ((const __m128i*) (a+i));
+            __m128i vb = _mm_loadu_si128 ((const __m128i*) (b+j));
+
+            __m128i m = _mm_or_si128 (
+                _mm_or_si128 (_mm_cmpeq_epi32 (va, vb),                                     _mm_cmpeq_epi32 (va, _mm_shuffle_epi32 (vb, _MM_SHUFFLE(0,3,2,1)))),
+                _mm_or_si128 (_mm_cmpeq_epi32 (va, _mm_shuffle_epi32 (vb, _MM_SHUFFLE(1,0,3,2))), _mm_cmpeq_epi32 (va, _mm_shuffle_epi32 (vb, _MM_SHUFFLE(2,1,0,3))))
+            );
+
+            count += __builtin_popcount (_mm_movemask_ps (_mm_castsi128_ps (m)));
+
+            uint32_t amax = a[i+3];
+            uint32_t bmax = b[j+3];
+            i += amax<=bmax ? 4 : 0;
+            j += bmax<=amax ? 4 : 0;
+        }
+
+        return count + intersect_count_scalar (a, na, b, nb, i, j);
+    }
+
+    __attribute__((target("avx2")))
+    inline std::size_t intersect_count_avx2 (const uint32_t* a, std::size_t na, const uint32_t* b, std::size_t nb)
+    {
+        std::size_t count = 0;
+        std::size_t i=0, j=0;
+
+        const __m256i rot = _mm256_setr_epi32 (1,2,3,4,5,6,7,0);
+
+        while (i+8<=na and j+8<=nb)
+        {
+            __m256i va = _mm256_loadu_si256 ((const __m256i*) (a+i));
+            __m256i vb = _mm256_loadu_si256 ((const __m256i*) (b+j));
+
+            __m256i m = _mm256_cmpeq_epi32 (va, vb);
+            for (int r=1; r<8; r++)
+            {
+                vb = _mm256_permutevar8x32_epi32 (vb, rot);
+                m  = _mm256_or_si256 (m, _mm256_cmpeq_epi32 (va, vb));
+            }
+
+            count += __builtin_popcount (_mm256_movemask_ps (_mm256_castsi256_ps (m)));
+
+            uint32_t amax = a[i+7];
+            uint32_t bmax = b[j+7];
+            i += amax<=bmax ? 8 : 0;
+            j += bmax<=amax ? 8 : 0;
+        }
+
+        return count + intersect_count_scalar (a, na, b, nb, i, j);
+    }
+
+    __attribute__((target("avx512f")))
+    inline std::size_t intersect_count_avx512 (const uint32_t* a, std::size_t na, const uint32_t* b, std::size_t nb)
+    {
+        std::size_t count = 0;
+        std::size_t i=0, j=0;
+
+        while (i+16<=na and j+16<=nb)
+        {
+            __m512i va = _mm512_loadu_si512 ((const void*) (a+i));
+            __m512i vb = _mm512_loadu_si512 ((const void*) (b+j));
+
+            __mmask16 m = _mm512_cmpeq_epi32_mask (va, vb);
+            for (int r=1; r<16; r++)
+            {
+                vb = _mm512_alignr_epi32 (vb, vb, 1);
+                m |= _mm512_cmpeq_epi32_mask (va, vb);
+            }
+
+            count += __builtin_popcount (m);
+
+            uint32_t amax = a[i+15];
+            uint32_t bmax = b[j+15];
+            i += amax<=bmax ? 16 : 0;
+            j += bmax<=amax ? 16 : 0;
+        }
+
+        return count + intersect_count_scalar (a, na, b, nb, i, j);
+    }
+
+#endif
+
+    inline std::size_t intersect_count_scalar_fct (const uint32_t* a, std::size_t na, const uint32_t* b, std::size_t nb)
+    {
+        return intersect_count_scalar (a, na, b, nb);
+    }
+}
+
+/** Get the best instruction set supported by the CPU. It can be lowered through the BPL_SIMD environment
+ * variable (scalar, sse, avx2 or avx512), which is useful for comparing the kernels.
+ * \return the SIMD level
+ */
+inline SimdLevel getSimdLevel ()
+{
+    static const SimdLevel level = []
+    {
+        SimdLevel result = SimdLevel::SCALAR;
+
+#ifdef BPL_INTERSECT_X86
+        __builtin_cpu_init();
+             if (__builtin_cpu_supports ("avx512f"))  { result = SimdLevel::AVX512; }
+        else if (__builtin_cpu_supports ("avx2"))     { result = SimdLevel::AVX2;   }
+        else if (__builtin_cpu_supports ("sse2"))     { result = SimdLevel::SSE;    }
+#endif
+
+        if (const char* d = getenv("BPL_SIMD"))
+        {
+            SimdLevel cap = result;
+                 if (strcmp(d,"scalar")==0)  { cap = SimdLevel::SCALAR; }
+            else if (strcmp(d,"sse")   ==0)  { cap = SimdLevel::SSE;    }
+            else if (strcmp(d,"avx2")  ==0)  { cap = SimdLevel::AVX2;   }
+            else if (strcmp(d,"avx512")==0)  { cap = SimdLevel::AVX512; }
+            if (cap < result)  { result = cap; }
+        }
+
+        return result;
+    } ();
+
+    return level;
+}
+
+/** Get the intersection kernel for a given instruction set.
+ * \param level: the instruction set (must be supported by the CPU)
+ * \return the kernel
+ */
+inline intersect_fct_t getIntersectKernel (SimdLevel level)
+{
+#ifdef BPL_INTERSECT_X86
+    switch (level)
+    {
+        case SimdLevel::AVX512:  return impl::intersect_count_avx512;
+        case SimdLevel::AVX2:    return impl::intersect_count_avx2;
+        case SimdLevel::SSE:     return impl::intersect_count_sse;
+        default:                 break;
+    }
+#endif
+    return impl::intersect_count_scalar_fct;
+}
+
+/** Count the common items of two sorted arrays, with the best kernel for the CPU (chosen once).
+ *
+ * NOTE: the items of each array must be strictly increasing; otherwise the SIMD kernels may count
+ * a repeated item several times and the result depends on the kernel.
+ *
+ * \param a: first array
+ * \param na: number of items of the first array
+ * \param b: second array
+ * \param nb: number of items of the second array
+ * \return the number of common items.
+ */
+inline std::size_t intersect_count (const uint32_t* a, std::size_t na, const uint32_t* b, std::size_t nb)
+{
+    static const intersect_fct_t kernel = getIntersectKernel (getSimdLevel());
+    return kernel (a, na, b, nb);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+};  // end of namespace
+////////////////////////////////////////////////////////////////////////////////
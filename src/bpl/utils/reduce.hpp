@@ -9,6 +9,9 @@
 #pragma once
 
 #include <vector>
+#include <map>
+#include <algorithm>
+#include <type_traits>
 #include <bpl/utils/metaprog.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -38,16 +41,86 @@ public:
  */
 template<bool,class TASK>  struct Reduce {};
 
-/** \brief Specialization 1: reduce the partial results by using 'reduce' method */
+/** \brief Specialization 1: reduce the partial results by using 'reduce' method
+ *
+ * The partial results can be reduced either serially on the calling thread, or through
+ * a parallel tree reduction when a thread pool is provided (see operator() overloads).
+ */
 template<class TASK>  struct Reduce<true,TASK>
 {
     using Result_t = return_t <decltype(&TASK::operator())>;
 
+    /** Below this number of partial results, a parallel reduction is not worth the scheduling cost. */
+    static constexpr std::size_t PARALLEL_MIN_NB = 64;
+
+    /** The tree reduction combines two partial reductions, so 'reduce' must accept two Result_t objects. */
+    static constexpr bool is_tree_reducible = std::is_invocable_v<decltype(TASK::reduce), Result_t, Result_t>;
+
     template<typename RESULT_RANGE>
     auto operator() (const RESULT_RANGE& results) const
     {
-        Result_t res = Result_t();
-        for (auto&& result: results)  {  res = TASK::reduce(res,result);  }
+        return fold (results, 0, results.size());
+    }
+
+    /** Reduce the partial results with a log-depth tree reduction executed on the provided thread pool.
+     *
+     * The results are first cut into contiguous blocks (one per thread) that are folded in parallel;
+     * the block reductions are then combined pairwise, level by level. Since the unit order is kept
+     * at each step and each block is seeded with its first result (not with Result_t()), the result
+     * is the same as the serial fold for any associative 'reduce' function, even non commutative ones
+     * or ones for which Result_t() is not an identity element (a 'min' for instance).
+     *
+     * \param results : the partial results
+     * \param pool : a thread pool providing 'submit_sequence' and 'get_thread_count' (ie. BS::thread_pool)
+     * \return the reduced result
+     */
+    template<typename RESULT_RANGE, typename POOL>
+    auto operator() (const RESULT_RANGE& results, POOL& pool) const
+    {
+        using value_t = std::decay_t<Result_t>;
+
+        std::size_t nbBlocks = std::min (std::size_t(pool.get_thread_count()), results.size()/2);
+
+        if constexpr (not is_tree_reducible)  {  return fold (results, 0, results.size());  }
+        else
+        {
+            if (results.size() < PARALLEL_MIN_NB or nbBlocks < 2)  {  return fold (results, 0, results.size());  }
+
+            // Step 1: each block of contiguous results is folded by one thread.
+            std::vector<value_t> partial = pool.template submit_sequence<std::size_t> (0, nbBlocks, [&] (std::size_t b)
+            {
+                return fold (results, results.size()*(b+0)/nbBlocks, results.size()*(b+1)/nbBlocks);
+            }).get();
+
+            // Step 2: the partial reductions are combined two by two until only one remains.
+            while (partial.size() > 1)
+            {
+                std::size_t n = partial.size();
+
+                partial = pool.template submit_sequence<std::size_t> (0, (n+1)/2, [&] (std::size_t i)
+                {
+                    return 2*i+1 < n ?
+                        value_t (TASK::reduce (partial[2*i], partial[2*i+1])) :
+                        std::move (partial[2*i]);
+                }).get();
+            }
+
+            return std::move (partial[0]);
+        }
+    }
+
+private:
+
+    /** Fold the results [i0,i1) in order. The fold is seeded with the first result, so 'reduce' needs
+     * no identity element; Result_t() is only returned for an empty range.
+     */
+    template<typename RESULT_RANGE>
+    static auto fold (const RESULT_RANGE& results, std::size_t i0, std::size_t i1)
+    {
+        if (i0 >= i1)  {  return Result_t();  }
+
+        Result_t res = results[i0];
+        for (std::size_t i=i0+1; i<i1; i++)  {  res = TASK::reduce(res,results[i]);  }
         return res;
     }
 };
@@ -62,6 +135,84 @@ template<class TASK>  struct Reduce<false,TASK>
     {
         return results;
     }
+
+    template<typename RESULT_RANGE, typename POOL>
+    auto& operator() (RESULT_RANGE& results, POOL& pool)
+    {
+        return results;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/** \brief Sink that reduces partial results as they arrive, in unit order.
+ *
+ * This class is intended to be used with 'stream' methods (see Launcher::stream) that provide
+ * the partial results in completion order. A result that arrives before its predecessors is kept
+ * aside until they are all reduced, so the final result is the same as the serial fold done by
+ * Reduce<true,TASK>, even for non commutative 'reduce' functions.
+ *
+ * The buffer of pending results is not bounded: the sink is called under the lock of the stream, so
+ * waiting for a missing predecessor there would stall every worker. Since the jobs are started in
+ * units order, it usually holds O(threads) results, but if an early unit is slow, all the units
+ * that complete after it are buffered, i.e. up to N-1 results for N units. 'maxPending' reports
+ * the high-water mark of a run, which can be used to size 'granularity' or the number of units.
+ *
+ * The sink itself is not thread safe; the caller is supposed to serialize the calls.
+ */
+template<class TASK>
+class OrderedReducer
+{
+public:
+
+    using Result_t = std::decay_t<return_t <decltype(&TASK::operator())>>;
+
+    /** Receive the partial result of a given process unit.
+     * \param idx : index of the process unit
+     * \param result : the partial result for this process unit
+     */
+    template<typename T>
+    void operator() (std::size_t idx, T&& result)
+    {
+        if (idx != next_)
+        {
+            pending_.emplace (idx, std::forward<T>(result));
+            maxPending_ = std::max (maxPending_, pending_.size());
+            return;
+        }
+
+        // Like Reduce<true,TASK>, the reduction is seeded with the first result.
+        if (next_==0)  {  value_ = std::forward<T>(result);          }
+        else           {  value_ = TASK::reduce (value_, result);  }
+        next_++;
+
+        // The following results may have been received already.
+        for (auto it = pending_.begin(); it != pending_.end() and it->first == next_; it = pending_.erase(it))
+        {
+            value_ = TASK::reduce (value_, it->second);
+            next_++;
+        }
+    }
+
+    /** Return the reduction of all the partial results received so far (in unit order).
+     * \return the reduced result
+     */
+    const Result_t& get() const { return value_; }
+
+    /** Number of partial results that have been reduced. */
+    std::size_t size() const { return next_; }
+
+    /** Number of partial results received but not reduced yet (waiting for a predecessor). */
+    std::size_t pending() const { return pending_.size(); }
+
+    /** Greatest number of partial results that have been waiting for a predecessor at the same time. */
+    std::size_t maxPending() const { return maxPending_; }
+
+private:
+    Result_t value_ = Result_t();
+    std::size_t next_ = 0;
+    std::size_t maxPending_ = 0;
+    std::map<std::size_t,Result_t> pending_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -833,17 +833,19 @@ struct bpl::serializable<bpl::Range>
     static auto iterate (bool transient, int depth, const T& t, FCT fct, void* context=nullptr)
     {
         //printf ("Range::iterate:  %ld %ld \n", *t.begin(), *t.end  ());
-        Serialize<ARCH,BUFITER,ROUNDUP>::iterate (true, depth+1, *t.begin(), fct, context);
-        Serialize<ARCH,BUFITER,ROUNDUP>::iterate (true, depth+1, *t.end  (), fct, context);
+        Serialize<ARCH,BUFITER,ROUNDUP>::iterate (true, depth+1, t.first (), fct, context);
+        Serialize<ARCH,BUFITER,ROUNDUP>::iterate (true, depth+1, t.last  (), fct, context);
+        Serialize<ARCH,BUFITER,ROUNDUP>::iterate (true, depth+1, t.stride(), fct, context);
     }
 
     template<class ARCH, class BUFITER, int ROUNDUP, typename T>
     static auto restore (BUFITER& it, T& result)
     {
-        Range::type a,b;
+        Range::size_type a,b,s;
         Serialize<ARCH,BUFITER,ROUNDUP>::restore (it, a);
         Serialize<ARCH,BUFITER,ROUNDUP>::restore (it, b);
-        result = Range (a,b);
+        Serialize<ARCH,BUFITER,ROUNDUP>::restore (it, s);
+        result = Range (a,b,s);
         //printf ("Range::restore:  %ld %ld \n", a, b);
     }
 };
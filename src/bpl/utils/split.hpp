@@ -9,6 +9,7 @@
 #include <firstinclude.hpp>
 
 #include <bpl/utils/splitter.hpp>
+#include <bpl/utils/StridedView.hpp>
 #include <vector>
 #include <span>
 
@@ -20,6 +21,31 @@ namespace bpl {
 // We define a few template specializations of SplitOperator for some std types
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace impl
+{
+    /** View on the items idx, idx+total, idx+2*total... of a contiguous buffer of n items (RAKE split). */
+    template<typename T>
+    auto view_rake (T* data, std::size_t n, std::size_t idx, std::size_t total)
+    {
+        std::size_t count = idx < n ? (n-idx+total-1) / total : 0;
+        return strided_view<T> (data, n, idx, total, count);
+    }
+
+    /** View on the ith part of a pseudo random permutation of a contiguous buffer of n items (RAND split).
+     * The part is the slice [p0,p1) of the permutation, i.e. the items perm(p0) + k*stride modulo n.
+     */
+    template<typename T>
+    auto view_rand (T* data, std::size_t n, std::size_t idx, std::size_t total, uint32_t seed)
+    {
+        std::size_t p0 = n * (idx+0) / total;
+        std::size_t p1 = n * (idx+1) / total;
+
+        SplitPermutation perm (n, seed);
+
+        return strided_view<T> (data, n, perm(p0), perm.stride(), p1-p0);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /** \brief Template specialization for a std::pair. */
 template <typename A,typename B>
@@ -39,6 +65,12 @@ struct SplitOperator<std::pair<A,B>>
 
     static auto split_view (const std::pair<A,B>& t, std::size_t idx, std::size_t total)
     {  return split (t, idx, total);  }
+
+    // Part holding the items [i0,i1) (used by weighted splits, see bpl::Weighted).
+    static auto split_interval (const std::pair<A,B>& t, std::size_t i0, std::size_t i1)
+    {  return std::pair { t.first+i0, t.first+i1 };  }
+
+    // NOTE: no RAKE/RAND split here since the result would not be an interval anymore (see bpl::Range for a strided interval).
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -64,6 +96,19 @@ struct SplitOperator<std::vector<T>>
     {
         return SplitOperator<std::span<T>>::split ((std::vector<T>&)t, idx, total);
     }
+
+    static auto split_interval (const std::vector<T>& t, std::size_t i0, std::size_t i1)
+    {  return std::vector<T> (t.begin()+i0, t.begin()+i1);  }
+
+    static auto split_interval_view (const std::vector<T>& t, std::size_t i0, std::size_t i1)
+    {  return SplitOperator<std::span<T>>::split_interval ((std::vector<T>&)t, i0, i1);  }
+
+    // NOTE: the RAKE/RAND parts are not contiguous, so they are provided as strided views on the vector.
+    static auto split_rake (const std::vector<T>& t, std::size_t idx, std::size_t total)
+    {  return impl::view_rake (t.data(), t.size(), idx, total);  }
+
+    static auto split_rand (const std::vector<T>& t, std::size_t idx, std::size_t total, uint32_t seed=0)
+    {  return impl::view_rand (t.data(), t.size(), idx, total, seed);  }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -90,6 +135,16 @@ struct SplitOperator<std::span<T>>
 
     static auto split_view (std::span<T> t, std::size_t idx, std::size_t total)
     {  return split (t, idx, total);  }
+
+    static auto split_interval (std::span<T> t, std::size_t i0, std::size_t i1)
+    {  return t.subspan (i0, i1-i0);  }
+
+    // NOTE: the RAKE/RAND parts are not contiguous, so they are provided as strided views on the span.
+    static auto split_rake (std::span<T> t, std::size_t idx, std::size_t total)
+    {  return impl::view_rake (t.data(), t.size(), idx, total);  }
+
+    static auto split_rand (std::span<T> t, std::size_t idx, std::size_t total, uint32_t seed=0)
+    {  return impl::view_rand (t.data(), t.size(), idx, total, seed);  }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -15,7 +15,9 @@ namespace bpl {
 ////////////////////////////////////////////////////////////////////////////////
 
     // Enumeration holding different parallelization schemes.
-    // NOTE: not used right now (only CONT is relevant)
+    // NOTE: CONT is provided by the 'split' method of SplitOperator specializations, RAKE and RAND by the
+    // optional 'split_rake' and 'split_rand' methods. RAKE and RAND are useful when the cost of an item
+    // depends on its position (a contiguous split would then give all the expensive items to the same unit).
     enum SplitKind
     {
         CONT = 0,   // split by contiguous chunks; ex: [0:5]  => [0,1,2] [2,3,4]
@@ -40,6 +42,7 @@ namespace impl
      * \param L    : type holding the level
      * \param KIND : a split scheme
      * \param TYPE : the type of the proxied object
+     * The proxy also holds the seed of the RAND split kind (see impl::SplitPermutation).
      */
     template<typename L, bpl::SplitKind KIND, typename TYPE>
     struct SplitProxy
@@ -55,8 +58,9 @@ namespace impl
 
         /** Constructor
          * \param t : the object we want to keep a reference on.
+         * \param seed : seed of the permutation for the RAND split kind.
          */
-        SplitProxy (const type& t) : _t(t)  {}
+        SplitProxy (const type& t, uint32_t seed=0) : _t(t), seed_(seed)  {}
 
         /** Cast operator
          * \return the reference on the proxied object
@@ -66,6 +70,9 @@ namespace impl
         /** reference on the object provided through the constructor.
          *    => we must be sure that this object lives while using a proxy on it. */
         const type& _t;
+
+        /** Seed of the permutation used by the RAND split kind. */
+        uint32_t seed_ = 0;
     };
 
     ////////////////////////////////////////////////////////////////////////////////
@@ -90,6 +97,113 @@ namespace impl
             DEFAULT::LEVEL :
             SplitProxy<L,K,T>::LEVEL;
     };
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /** Type trait that returns the split kind from a type (CONT by default). */
+    template<typename T>
+    struct GetSplitKind
+    {
+        static const bpl::SplitKind value = bpl::SplitKind::CONT;
+    };
+
+    /** Type trait specialization for the SplitProxy type. */
+    template<typename L, bpl::SplitKind K, typename T>
+    struct GetSplitKind<SplitProxy<L,K,T>>
+    {
+        static const bpl::SplitKind value = K;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /** \brief Bijection on [0,n) used by the RAND split kind.
+     *
+     * We use an affine map p -> (a*p+c) mod n where 'a' is coprime with n and close to n/phi, so that
+     * neighbour positions are sent far from each other. Such a permutation is deterministic (same split
+     * on host and PIM sides), needs no memory and can be inverted, which is required when the items can
+     * only be iterated (for instance a bpl::vector on the DPU side).
+     *
+     * A seed selects another permutation of the same family (both 'a' and 'c' depend on it), so a run can
+     * be reproduced by providing the same seed. The seed 0 gives the default permutation.
+     *
+     * Since positions p0..p1 are sent to (perm(p0) + k*a) mod n, a slice of the permutation is a
+     * strided view on the items (see bpl::strided_view).
+     */
+    class SplitPermutation
+    {
+    public:
+
+        /** Constructor.
+         * \param n : size of the domain
+         * \param seed : seed selecting the permutation
+         */
+        SplitPermutation (uint64_t n, uint32_t seed=0) : n_(n)
+        {
+            // We scramble the seed so that close seeds give unrelated permutations.
+            uint64_t h = seed==0 ? 0 : mix (seed);
+
+            if (n_ > 2)
+            {
+                a_ = (n_ * 40503) >> 16;  // 40503/65536 ~ 1/phi
+                a_ += h % (n_/8 + 1);     // the seed moves 'a' in [n/phi, n/phi + n/8] and keeps the spreading
+                if (a_==0 or a_>=n_)  { a_ = 1; }
+                while (gcd (a_,n_) != 1)  { a_++; }
+                c_ = (n_/2 + (h>>32)) % n_;
+            }
+            else if (n_ > 0)
+            {
+                c_ = h % n_;
+            }
+            ainv_ = invmod (a_, n_);
+        }
+
+        /** Item index at a given position. */
+        uint64_t operator() (uint64_t p) const  {  return n_>0 ? (mulmod (a_,p) + c_) % n_ : 0;  }
+
+        /** Position of a given item index. */
+        uint64_t inverse (uint64_t i) const  {  return n_>0 ? mulmod (ainv_, (i + n_ - c_) % n_) : 0;  }
+
+        /** Distance (modulo n) between the items of two consecutive positions. */
+        uint64_t stride () const  {  return a_;  }
+
+    private:
+
+        uint64_t n_    = 0;
+        uint64_t a_    = 1;
+        uint64_t c_    = 0;
+        uint64_t ainv_ = 1;
+
+        uint64_t mulmod (uint64_t x, uint64_t y) const
+        {
+#if defined(__SIZEOF_INT128__)
+            return (unsigned __int128)x * y % n_;
+#else
+            return x * y % n_;   // no 128 bits integers (e.g. DPU) -> domain supposed to be < 2^32
+#endif
+        }
+
+        static uint64_t mix (uint64_t x)
+        {
+            x += 0x9e3779b97f4a7c15ULL;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+
+        static uint64_t gcd (uint64_t x, uint64_t y)  {  while (y!=0) { uint64_t t=x%y; x=y; y=t; }  return x;  }
+
+        static uint64_t invmod (uint64_t a, uint64_t n)
+        {
+            int64_t t=0, nt=1, r=n, nr=a;
+            while (nr != 0)
+            {
+                int64_t q = r / nr;
+                int64_t tmp;
+                tmp = t - q*nt;  t = nt;  nt = tmp;
+                tmp = r - q*nr;  r = nr;  nr = tmp;
+            }
+            if (t<0)  { t += n; }
+            return n>0 ? uint64_t(t) % n : 0;
+        }
+    };
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -107,6 +221,31 @@ static constexpr bool is_splitable_v = requires(const T& t, size_t idx, size_t t
 template<typename T, typename TASK>
 static constexpr bool is_custom_splitable_v = requires(const T& t, size_t idx, size_t total ) { TASK::split(t, idx, total); };
 
+// A type is 'splitable' for a given kind if it provides the method matching this kind (split, split_rake or split_rand)
+template<typename T, bpl::SplitKind KIND>
+static constexpr bool is_splitable_kind_v =
+    (KIND==SplitKind::CONT and is_splitable_v<T>) or
+    (KIND==SplitKind::RAKE and requires(const T& t, size_t idx, size_t total ) { SplitOperator<std::decay_t<T>>::split_rake(t, idx, total); }) or
+    (KIND==SplitKind::RAND and requires(const T& t, size_t idx, size_t total ) { SplitOperator<std::decay_t<T>>::split_rand(t, idx, total); });
+
+/** Compute the ith partition of an object according to a split kind.
+ * \param t : the object to be split
+ * \param idx : the index of the partition to be computed
+ * \param total : total number of partitions
+ * \param seed : seed of the permutation (RAND only)
+ * \return the ith partition
+ */
+template<bpl::SplitKind KIND, typename T>
+requires (is_splitable_kind_v<T,KIND>)
+auto split_kind (const T& t, size_t idx, size_t total, uint32_t seed=0)
+{
+    using operator_t = SplitOperator<std::decay_t<T>>;
+
+    if constexpr (KIND==SplitKind::RAKE)  {  return operator_t::split_rake (t,idx,total);  }
+    else if constexpr (KIND==SplitKind::RAND)  {  return operator_t::split_rand (t,idx,total,seed);  }
+    else                                       {  return operator_t::split      (t,idx,total);  }
+}
+
 template<typename T,typename TASK=void>
 requires (is_splitable_v<T>)
 auto split (const T& t, size_t idx, size_t total)  {  return SplitOperator<T>::split (t,idx,total);  }
@@ -127,6 +266,31 @@ template<typename T, typename TASK>
 requires (is_custom_splitable_v<T, TASK>)
 auto split_assign (T& t, size_t idx, size_t total)  {  t = split<T,TASK> (t,idx,total); }
 
+/** Split an object in place according to a split kind known at runtime (typically received by a PIM unit).
+ * If the type doesn't support the required kind (or if the task provides its own split), we use the default split.
+ */
+template<typename T, typename TASK>
+auto split_assign (T& t, size_t idx, size_t total, bpl::SplitKind kind, uint32_t seed=0)
+{
+    // A part provided as a view on 't' (see bpl::strided_view) has to be gathered before being assigned to 't'.
+    auto assign = [&] (auto&& part)
+    {
+        if constexpr (requires { part.to_vector(); })  {  t = part.to_vector();  }
+        else                                           {  t = std::move(part);   }
+    };
+
+    if constexpr (not is_custom_splitable_v<T,TASK> and is_splitable_kind_v<T,SplitKind::RAKE>)
+    {
+        if (kind==SplitKind::RAKE)  {  assign (split_kind<SplitKind::RAKE> (t,idx,total));  return;  }
+    }
+    if constexpr (not is_custom_splitable_v<T,TASK> and is_splitable_kind_v<T,SplitKind::RAND>)
+    {
+        if (kind==SplitKind::RAND)  {  assign (split_kind<SplitKind::RAND> (t,idx,total,seed));  return;  }
+    }
+
+    split_assign<T,TASK> (t,idx,total);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /** \brief Choose the correct 'split' function to be called according to the provided template type information.
@@ -186,6 +350,20 @@ auto  split (const TYPE& t)
     return impl::SplitProxy<LEVEL,bpl::SplitKind::CONT,TYPE> (t);
 }
 
+/** Method that encapsulates an incoming object of type T with a specific split kind.
+ * \param LEVEL : the level type
+ * \param KIND  : the split kind (CONT, RAKE or RAND)
+ * \param TYPE  : the type of the object
+ * \param seed  : seed of the permutation for RAND, the same seed giving the same parts
+ * \return a SplitProxy instance that proxies the incoming object
+ */
+template<typename LEVEL, bpl::SplitKind KIND, typename TYPE>
+auto  split (const TYPE& t, uint32_t seed=0)
+{
+    static_assert (KIND==SplitKind::CONT or is_splitable_kind_v<TYPE,KIND>, "split kind not supported by this type");
+    return impl::SplitProxy<LEVEL,KIND,TYPE> (t, seed);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /** Method that encapsulates an incoming object of type T.
  * \param TYPE  : the type of the object
@@ -209,6 +387,18 @@ auto  split (const TYPE& t)
     return split<impl::DummyLevel,TYPE> (t);
 }
 
+/** Method that encapsulates an incoming object of type T with a specific split kind.
+ * \param KIND  : the split kind (CONT, RAKE or RAND)
+ * \param TYPE  : the type of the object
+ * \param seed  : seed of the permutation for RAND, the same seed giving the same parts
+ * \return a SplitProxy instance that proxies the incoming object
+ */
+template<bpl::SplitKind KIND, typename TYPE>
+auto  split (const TYPE& t, uint32_t seed=0)
+{
+    return split<impl::DummyLevel,KIND,TYPE> (t, seed);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /** \brief Type trait providing a boolean telling whether or not the provided type is a SplitProxy instance
@@ -263,6 +453,40 @@ void retrieveSplitStatus (uint8_t status[32])
     int i=0;   ( (status[i] = impl::GetSplitStatus<ARGS,DEFAULT>::value, i++), ...);
 }
 
+/** Compute the split kind of a parameters pack as an array of integer values (see SplitKind).
+ * \param kind : array (size 32) to be filled with the split kinds
+ */
+template<typename ...ARGS>
+void retrieveSplitKind (uint8_t kind[32])
+{
+    static_assert (sizeof...(ARGS)<=32);
+
+    for (int i=0; i<32; i++)  { kind[i]=SplitKind::CONT; }
+
+    int i=0;   ( (kind[i] = impl::GetSplitKind<std::decay_t<ARGS>>::value, i++), ...);
+}
+
+/** Retrieve the seed of the RAND split of each argument of a tuple (0 for the other arguments).
+ * \param targs : the arguments
+ * \param seed : array (size 32) to be filled with the seeds
+ */
+template<typename ...ARGS>
+void retrieveSplitSeed (const std::tuple<ARGS...>& targs, uint32_t seed[32])
+{
+    static_assert (sizeof...(ARGS)<=32);
+
+    for (int i=0; i<32; i++)  { seed[i]=0; }
+
+    std::apply ([&] (const auto&... args)
+    {
+        int i=0;
+        ( (seed[i] = [&] () -> uint32_t {
+            if constexpr (is_splitter_v<std::decay_t<decltype(args)>>)  {  return args.seed_;  }
+            else                                                        {  return 0;           }
+        } (), i++), ...);
+    }, targs);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /** \brief Type trait specialization in case the incoming type is a SplitProxy */
 template<typename LEVEL, bpl::SplitKind KIND, typename TYPE>
@@ -276,8 +500,9 @@ struct SplitOperator<impl::SplitProxy<LEVEL,KIND,TYPE>>
      */
     static decltype(auto) split (const impl::SplitProxy<LEVEL,KIND,TYPE>& t, std::size_t idx, std::size_t total)
     {
-        // We simply forward to the encapsulated object.
-        return SplitOperator<TYPE>::split (t, idx, total);
+        // We simply forward to the encapsulated object, according to the split kind.
+        if constexpr (KIND==SplitKind::CONT)  {  return SplitOperator<TYPE>::split (t, idx, total);  }
+        else                                  {  return split_kind<KIND> ((const TYPE&)t, idx, total, t.seed_);  }
     }
 };
 
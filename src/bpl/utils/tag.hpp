@@ -25,6 +25,13 @@ template<typename T>  struct global_converter  {  using type = T; };
 /** \brief Converter that does nothing but returning the T type. */
 template<typename T>  struct null_converter    {  using type = T; };
 
+/** \brief Type trait telling whether a tag keeps a copy of the tagged object instead of a reference on it.
+ *
+ * This is intended for lightweight views (e.g. a std::span) that are built on the fly from the actual
+ * argument (e.g. a std::vector): a reference on such a temporary would be dangling.
+ */
+template<typename T>  struct tag_by_value : std::false_type {};
+
 /** \brief Definition of a tag for a given type T.
  *
  * 'tag' allows to encapsulate a type T in order to associate some semantics to T.
@@ -47,7 +54,7 @@ struct tag
     decltype(auto) operator-> ()       { return  std::addressof(ref_); }
     decltype(auto) operator*  ()       { return  ref_;  }
 
-    const T& ref_;
+    std::conditional_t<tag_by_value<T>::value, const T, const T&> ref_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -86,6 +93,7 @@ struct first_non_tag<TAG<T>> : first_non_tag<T> {};
         NAME& operator= (      NAME&&) = default;               \
                                                                 \
         template<typename U>                                    \
+        requires (not std::is_same_v<std::decay_t<U>,NAME>)     \
         NAME(U&& u) : tag<NAME##_type<T>> (u) {}                \
     };                                                          \
                                                                 \
@@ -129,6 +137,11 @@ inline constexpr bool hastag_v = hastag<TAG,T>::value;
 TAG_DEFINITION (once,     null_converter);
 TAG_DEFINITION (global, global_converter);
 
+/** The 'output' tag marks a parameter as a preallocated buffer (e.g. output<span<T>>) provided by the caller
+ * through a split argument: each process unit gets a view on its own part of the buffer and writes its
+ * results in place, so they are neither returned by value nor gathered and concatenated afterwards. */
+TAG_DEFINITION (output,   null_converter);
+
 ////////////////////////////////////////////////////////////////////////////////
 };  // end of namespace
 ////////////////////////////////////////////////////////////////////////////////
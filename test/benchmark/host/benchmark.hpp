@@ -8,34 +8,382 @@
 #include <bpl/utils/TimeUtils.hpp>
 #include <bpl/utils/getname.hpp>
 
+#include <vector>
+#include <map>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+
 //////////////////////////////////////////////////////////////////////////////
+/** \brief Benchmark of tasks over a set of launchers and inputs.
+ *
+ * Each (launcher,input) measure is made of some warm-up runs, then of timed runs repeated until the confidence
+ * interval of the median time is narrow enough (or until a maximum number of runs or a time budget is reached).
+ * The reported time is the median of the runs, with the MAD (median absolute deviation) as dispersion.
+ *
+ * The configuration comes from the environment:
+ *   - BPL_BENCH_WARMUP     : number of warm-up runs (default 0, at least 1 for the tasks asking for it)
+ *   - BPL_BENCH_MIN_RUNS   : minimum number of timed runs (default 5)
+ *   - BPL_BENCH_MAX_RUNS   : maximum number of timed runs (default 50)
+ *   - BPL_BENCH_MAX_TIME   : time budget of the timed runs of a measure, in seconds (default 5)
+ *   - BPL_BENCH_CI         : target half width of the confidence interval, relative to the median (default 0.02)
+ *   - BPL_BENCH_CONFIDENCE : confidence level of the interval (default 0.95)
+ *   - BPL_BENCH_FORMAT     : 'text' (one line per measure, as in notebooks/traces), 'json' or 'csv'
+ *   - BPL_BENCH_OUTPUT     : file receiving the json or csv report at the end (default 'benchmark.json' or
+ *                            'benchmark.csv', '-' for the standard output)
+ *   - BPL_BENCH_BASELINE   : text traces (see notebooks/traces) the measures are compared to
+ *   - BPL_BENCH_THRESHOLD  : relative slowdown above which a measure is a regression (default 0.05)
+ *
+ * In compare mode (BPL_BENCH_BASELINE set), a measure slower than the baseline by more than the threshold,
+ * the baseline being out of the confidence interval, is reported as a regression on the error output and
+ * makes the test case fail.
+ */
 struct Benchmark
 {
+    /** \brief Configuration of the benchmark. */
+    struct Config
+    {
+        size_t      warmup     = 0;
+        size_t      minRuns    = 5;
+        size_t      maxRuns    = 50;
+        double      maxTime    = 5.0;
+        double      ci         = 0.02;
+        double      confidence = 0.95;
+        std::string format     = "text";
+        std::string output;
+        std::string baseline;
+        double      threshold  = 0.05;
+
+        /** \return the configuration given by the environment. */
+        static Config fromEnvironment()
+        {
+            Config c;
+            auto get = [] (const char* name, auto& value)
+            {
+                const char* d = getenv (name);
+                if (d==nullptr or *d==0)  { return; }
+                if constexpr (std::is_same_v<std::decay_t<decltype(value)>,std::string>)  {  value = d;                 }
+                else if constexpr (std::is_integral_v<std::decay_t<decltype(value)>>)      {  value = std::stoul (d);    }
+                else                                                                       {  value = std::stod  (d);    }
+            };
+            get ("BPL_BENCH_WARMUP",     c.warmup);
+            get ("BPL_BENCH_MIN_RUNS",   c.minRuns);
+            get ("BPL_BENCH_MAX_RUNS",   c.maxRuns);
+            get ("BPL_BENCH_MAX_TIME",   c.maxTime);
+            get ("BPL_BENCH_CI",         c.ci);
+            get ("BPL_BENCH_CONFIDENCE", c.confidence);
+            get ("BPL_BENCH_FORMAT",     c.format);
+            get ("BPL_BENCH_OUTPUT",     c.output);
+            get ("BPL_BENCH_BASELINE",   c.baseline);
+            get ("BPL_BENCH_THRESHOLD",  c.threshold);
+            c.maxRuns = std::max (c.maxRuns, c.minRuns);
+            return c;
+        }
+
+        /** \return the quantile of the normal distribution matching the confidence level. */
+        double getZ() const
+        {
+            // Bisection on the two sided probability erf(z/sqrt(2)).
+            double lo=0, hi=10;
+            for (size_t i=0; i<100; i++)
+            {
+                double mid = (lo+hi)/2;
+                if (std::erf (mid/std::sqrt(2.0)) < confidence)  { lo=mid; }  else  { hi=mid; }
+            }
+            return (lo+hi)/2;
+        }
+    };
+
+    /** \return the configuration of the process. */
+    static const Config& config()
+    {
+        static Config c = Config::fromEnvironment();
+        return c;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    /** \brief Durations (in seconds) of the timed runs of a measure, with their robust statistics. */
+    struct Measure
+    {
+        std::vector<double> times;
+
+        /** Phase times of a run (mean over the timed runs), from the launcher statistics. */
+        double all=0, launch=0, pre=0, post=0, result=0;
+
+        size_t getNbRuns() const  {  return times.size();  }
+
+        /** \return the median of the durations. */
+        double getMedian() const  {  return median (times);  }
+
+        /** \return the median absolute deviation of the durations. */
+        double getMAD() const
+        {
+            double m = getMedian();
+            std::vector<double> dev;
+            for (auto t : times)  {  dev.push_back (std::abs (t-m));  }
+            return median (dev);
+        }
+
+        double getMin() const  {  return times.empty() ? 0 : *std::min_element (times.begin(), times.end());  }
+        double getMax() const  {  return times.empty() ? 0 : *std::max_element (times.begin(), times.end());  }
+
+        /** Confidence interval of the median, from the order statistics (no assumption on the distribution).
+         * \param z : quantile of the normal distribution for the confidence level
+         * \return the bounds of the interval; (0,inf) if there are too few runs */
+        std::pair<double,double> getInterval (double z) const
+        {
+            double n  = times.size();
+            double lo = std::floor ((n - z*std::sqrt(n)) / 2);
+            double hi = std::ceil  (1 + (n + z*std::sqrt(n)) / 2);
+            if (lo < 1 or hi > n)  {  return { 0, HUGE_VAL };  }
+
+            std::vector<double> sorted = times;
+            std::sort (sorted.begin(), sorted.end());
+            return { sorted[size_t(lo)-1], sorted[size_t(hi)-1] };
+        }
+
+        /** \return true if the half width of the confidence interval is small enough w.r.t. the median. */
+        bool isConverged (const Config& c) const
+        {
+            auto [lo,hi] = getInterval (c.getZ());
+            return (hi-lo)/2 <= c.ci * getMedian();
+        }
+
+    private:
+        static double median (std::vector<double> v)
+        {
+            if (v.empty())  { return 0; }
+            std::sort (v.begin(), v.end());
+            size_t n = v.size();
+            return n%2==1 ? v[n/2] : (v[n/2-1] + v[n/2]) / 2;
+        }
+    };
+
+    //////////////////////////////////////////////////////////////////////////////
+    /** \brief Result of a measure, identified as in the text traces. */
+    struct Record
+    {
+        std::string task;
+        std::string arch;
+        std::string unit;
+        size_t      nbComponents = 0;
+        size_t      nbUnits      = 0;
+        std::string input;
+        Measure     measure;
+
+        /** Key of the record in a baseline. */
+        std::string key() const  {  return fmt::format ("{}|{}|{}|{}|{}|{}", task, arch, unit, nbComponents, nbUnits, input);  }
+    };
+
+    /** \brief Records of the process, written at exit in json or csv (see Config). */
+    struct Report
+    {
+        std::mutex          mutex;
+        std::vector<Record> records;
+
+        static Report& instance()
+        {
+            static Report* report = []
+            {
+                std::atexit ([]  {  instance().write();  });
+                return new Report();
+            } ();
+            return *report;
+        }
+
+        void add (const Record& r)
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+            records.push_back (r);
+        }
+
+        void write()
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+
+            auto const& c = config();
+            if (records.empty() or (c.format!="json" and c.format!="csv"))  { return; }
+
+            std::string path = c.output.empty() ? "benchmark." + c.format : c.output;
+
+            FILE* file = path=="-" ? stdout : fopen (path.c_str(), "w");
+            if (file==nullptr)  {  fmt::println (stderr, "benchmark: unable to write '{}'", path);  return;  }
+
+            double z = c.getZ();
+
+            if (c.format=="csv")
+            {
+                fmt::println (file, "task,arch,unit,nbcomp,nbunits,input,runs,median,mad,min,max,ci_low,ci_high,all,launch,pre,post,result");
+            }
+            else
+            {
+                fmt::println (file, "[");
+            }
+
+            for (size_t i=0; i<records.size(); i++)
+            {
+                auto const& r = records[i];
+                auto const& m = r.measure;
+                auto [lo,hi]  = m.getInterval (z);
+                if (hi==HUGE_VAL)  {  hi = m.getMax();  }
+
+                if (c.format=="csv")
+                {
+                    fmt::println (file, "{},{},{},{},{},{},{},{:.9f},{:.9f},{:.9f},{:.9f},{:.9f},{:.9f},{:.9f},{:.9f},{:.9f},{:.9f},{:.9f}",
+                        csv(r.task), csv(r.arch), csv(r.unit), r.nbComponents, r.nbUnits, csv(r.input), m.getNbRuns(),
+                        m.getMedian(), m.getMAD(), m.getMin(), m.getMax(), lo, hi,
+                        m.all, m.launch, m.pre, m.post, m.result
+                    );
+                }
+                else
+                {
+                    fmt::println (file, "  {{\"task\":\"{}\", \"arch\":\"{}\", \"unit\":\"{}\", \"nbcomp\":{}, \"nbunits\":{}, \"input\":\"{}\", "
+                        "\"runs\":{}, \"median\":{:.9f}, \"mad\":{:.9f}, \"min\":{:.9f}, \"max\":{:.9f}, \"ci\":[{:.9f},{:.9f}], "
+                        "\"phases\":{{\"all\":{:.9f}, \"launch\":{:.9f}, \"pre\":{:.9f}, \"post\":{:.9f}, \"result\":{:.9f}}}}}{}",
+                        json(r.task), json(r.arch), json(r.unit), r.nbComponents, r.nbUnits, json(r.input), m.getNbRuns(),
+                        m.getMedian(), m.getMAD(), m.getMin(), m.getMax(), lo, hi,
+                        m.all, m.launch, m.pre, m.post, m.result,
+                        i+1<records.size() ? "," : ""
+                    );
+                }
+            }
+
+            if (c.format=="json")  {  fmt::println (file, "]");  }
+
+            if (file!=stdout)  {  fclose (file);  }
+        }
+
+        /** \return the content of a json string, with the quotes, backslashes and control characters escaped. */
+        static std::string json (const std::string& s)
+        {
+            std::string result;
+            for (unsigned char ch : s)
+            {
+                if      (ch=='"' or ch=='\\')  {  result += '\\';  result += ch;                 }
+                else if (ch < 0x20)            {  result += fmt::format ("\\u{:04x}", ch);  }
+                else                           {  result += ch;                                }
+            }
+            return result;
+        }
+
+        /** \return a csv field, quoted (with doubled quotes) if it holds a separator, a quote or a line break. */
+        static std::string csv (const std::string& s)
+        {
+            if (s.find_first_of (",\"\r\n") == std::string::npos)  { return s; }
+            std::string result = "\"";
+            for (char ch : s)  {  if (ch=='"')  { result += '"'; }  result += ch;  }
+            return result + "\"";
+        }
+    };
+
+    //////////////////////////////////////////////////////////////////////////////
+    /** \brief Reference times read from a text traces file (see notebooks/traces). */
+    struct Baseline
+    {
+        std::map<std::string,double> times;
+
+        /** \return the baseline of the process (empty if no BPL_BENCH_BASELINE). */
+        static const Baseline& instance()
+        {
+            static Baseline baseline = [] ()
+            {
+                Baseline result;
+                if (not config().baseline.empty())  {  result.load (config().baseline);  }
+                return result;
+            } ();
+            return baseline;
+        }
+
+        /** Read a traces file, whose lines are formatted as in 'defaultCallback'.
+         * \param path : path of the file */
+        void load (const std::string& path)
+        {
+            std::ifstream file (path);
+            if (not file)  { throw std::runtime_error ("unable to read benchmark baseline " + path); }
+
+            std::string line;
+            while (std::getline (file, line))
+            {
+                std::istringstream is (line);
+                std::vector<std::string> tokens;
+                for (std::string tok; is >> tok; )  {  tokens.push_back (tok);  }
+                if (tokens.size() < 17 or tokens[0] != "task:")  { continue; }
+
+                Record r { tokens[1], tokens[3], tokens[5], std::stoul(tokens[6]), std::stoul(tokens[7]), tokens[16], {} };
+                times[r.key()] = std::stod (tokens[9]);
+            }
+        }
+    };
+
+    /** Number of regressions found in compare mode. */
+    static size_t& nbRegressions()  {  static size_t nb = 0;  return nb;  }
+
+    /** Compare a record to the baseline (if any), and report a regression or an improvement on the error output. */
+    static void compare (const Record& r)
+    {
+        auto const& baseline = Baseline::instance();
+        auto it = baseline.times.find (r.key());
+        if (it == baseline.times.end())  { return; }
+
+        double ref    = it->second;
+        double median = r.measure.getMedian();
+        auto [lo,hi]  = r.measure.getInterval (config().getZ());
+
+        const char* status = "same";
+        if      (median > ref*(1+config().threshold) and ref < lo)  {  status = "REGRESSION";  nbRegressions()++;  }
+        else if (median < ref*(1-config().threshold) and ref > hi)  {  status = "improvement";  }
+
+        fmt::println (stderr, "compare: {:15}  arch: {:10}  unit: {:8s} {:4} {:5}  in: {:3}  baseline: {:10.6f}  median: {:10.6f}  ratio: {:6.3f}  {}",
+            r.task, r.arch, r.unit, r.nbComponents, r.nbUnits, r.input, ref, median, median/ref, status
+        );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
     static constexpr auto defaultCallback = [] (
             std::string_view taskname,
             auto&& launcher,
-            double duration,
+            const Measure& measure,
             auto&& input,
             size_t nbruns=2
         ) {
 
-        double time1 = launcher.getStatistics().getTiming("run/cumul/all")      / nbruns;
-        double time2 = launcher.getStatistics().getTiming("run/cumul/launch")   / nbruns;
-        double time3 = launcher.getStatistics().getTiming("run/cumul/pre")      / nbruns;
-        double time4 = launcher.getStatistics().getTiming("run/cumul/post")     / nbruns;
-        double time5 = launcher.getStatistics().getTiming("run/cumul/result")   / nbruns;
-
-        fmt::println ("task: {:15}  arch: {:10}  unit: {:8s} {:4} {:5}  time: {:10.6f} {:10.6f} {:10.6f} {:10.6f} {:10.6f} {:10.6f}  in: {:3}",
-            taskname,
-            launcher.name(),
-            launcher.getTaskUnit()->name(),
-            launcher.getTaskUnit()->getNbComponents(),
-            launcher.getTaskUnit()->getNbUnits(),
-            duration, time1, time2, time3, time4, time5,
-            input
-        );
+        Record r {
+            std::string (taskname),
+            std::string (launcher.name()),
+            std::string (launcher.getTaskUnit()->name()),
+            size_t (launcher.getTaskUnit()->getNbComponents()),
+            size_t (launcher.getTaskUnit()->getNbUnits()),
+            fmt::format ("{}", input),
+            measure
+        };
+
+        if (config().format=="text")
+        {
+            // Same columns as the notebooks/traces files (time being the median), the extra ones at the end.
+            fmt::println ("task: {:15}  arch: {:10}  unit: {:8s} {:4} {:5}  time: {:10.6f} {:10.6f} {:10.6f} {:10.6f} {:10.6f} {:10.6f}  in: {:3}  runs: {:3}  mad: {:10.6f}",
+                r.task, r.arch, r.unit, r.nbComponents, r.nbUnits,
+                measure.getMedian(), measure.all, measure.launch, measure.pre, measure.post, measure.result,
+                input, measure.getNbRuns(), measure.getMAD()
+            );
+        }
+
+        Report::instance().add (r);
+
+        compare (r);
     };
 
+    /** Run a benchmark over launchers and inputs.
+     * \param launchersViews : tuple of ranges of launchers
+     * \param inputs : inputs of the benchmark
+     * \param fct : function (launcher,input,nbruns) returning the measure and the task name
+     * \param nbruns : minimum number of timed runs (see also BPL_BENCH_MIN_RUNS)
+     */
     template<typename...Ls>
     static auto run (
         std::tuple<Ls...> launchersViews,
@@ -44,11 +392,13 @@ struct Benchmark
         size_t nbruns=2
     )
     {
+        size_t nbRegressionsBefore = nbRegressions();
+
         auto exec = [&] (auto launchers) {
-            for (auto arg : inputs) {  // 'inputs' before 'launchers' => mandatory for exact cumulation times for launchers
+            for (auto arg : inputs) {
                 for (auto l : launchers) {
-                    auto [time,taskname] = fct(l, arg, nbruns);
-                    defaultCallback (taskname, l, time, arg, nbruns);
+                    auto [measure,taskname] = fct(l, arg, nbruns);
+                    defaultCallback (taskname, l, measure, arg, nbruns);
                 }
             }
         };
@@ -56,24 +406,82 @@ struct Benchmark
         [&] <std::size_t...Is> (std::index_sequence<Is...>){
             ( exec (std::get<Is>(launchersViews)), ...);
         } (std::make_index_sequence<sizeof...(Ls)>() );
+
+        CHECK (nbRegressions() == nbRegressionsBefore);
     }
 
     //////////////////////////////////////////////////////////////////////////////
+    /** Warm-up runs of a function, not timed.
+     * \param fct : the function
+     * \param firstWithoutTime : true if at least one warm-up run is required; otherwise there are only the
+     *                           BPL_BENCH_WARMUP runs, none by default
+     */
+    static void warmup (auto&& fct, bool firstWithoutTime)
+    {
+        size_t nb = std::max (config().warmup, size_t(firstWithoutTime ? 1 : 0));
+        for (size_t i=0; i<nb; i++)  {  fct();  }
+    }
+
+    /** Timed runs of a function, repeated until the confidence interval of the median is narrow enough.
+     * \param fct : the function
+     * \param nbruns : minimum number of timed runs (see also BPL_BENCH_MIN_RUNS)
+     * \return the durations of the runs
+     */
+    static Measure repeat (auto&& fct, size_t nbruns)
+    {
+        auto const& c = config();
+
+        size_t minRuns = std::max (c.minRuns, nbruns);
+        size_t maxRuns = std::max (c.maxRuns, minRuns);
+
+        Measure measure;
+        double  elapsed = 0;
+
+        while (measure.getNbRuns() < maxRuns)
+        {
+            if (measure.getNbRuns() >= minRuns and (elapsed >= c.maxTime or measure.isConverged(c)))  { break; }
+
+            auto t0 = bpl::timestamp_ns();
+            fct();
+            auto t1 = bpl::timestamp_ns();
+
+            measure.times.push_back ((t1-t0) * 1e-9);
+            elapsed += (t1-t0) * 1e-9;
+        }
+
+        return measure;
+    }
+
+    /** Measure the runs of a task with a launcher.
+     * \param launcher : the launcher
+     * \param nbruns : minimum number of timed runs (see also BPL_BENCH_MIN_RUNS)
+     * \param firstWithoutTime : true if at least one warm-up run is required (see also BPL_BENCH_WARMUP)
+     * \param args : arguments of the task
+     * \return the measure and the name of the task
+     */
     template<template<typename> class Task, typename...Args>
     static auto run (auto&& launcher, size_t nbruns, bool firstWithoutTime, Args&&...args)
     {
         // We retrieve the task name from the type
         auto taskname = bpl::type_shortname<Task<bpl::ArchDummy>>();
 
-    	if (firstWithoutTime) {
-    		 launcher.template run<Task> (std::forward<Args>(args)...);
-    		 launcher.resetStatistics();
-    	}
+        auto fct = [&]  {  launcher.template run<Task> (std::forward<Args>(args)...);  };
+
+        warmup (fct, firstWithoutTime);
+
+        // The phases times are those of the timed runs only.
+        launcher.resetStatistics();
+
+        Measure measure = repeat (fct, nbruns);
 
-        auto t0 = bpl::timestamp();
-        for (size_t i=0; i<nbruns; i++) {   launcher.template run<Task> (std::forward<Args>(args)...);  }
-        auto t1 = bpl::timestamp();
+        auto const& stats = launcher.getStatistics();
+        double n = measure.getNbRuns();
+        measure.all    = stats.getTiming("run/cumul/all")    / n;
+        measure.launch = stats.getTiming("run/cumul/launch") / n;
+        measure.pre    = stats.getTiming("run/cumul/pre")    / n;
+        measure.post   = stats.getTiming("run/cumul/post")   / n;
+        measure.result = stats.getTiming("run/cumul/result") / n;
 
-        return std::make_tuple ((t1-t0)/nbruns/1'000'000.0, taskname);
+        return std::make_tuple (measure, taskname);
     }
 };
@@ -7,9 +7,11 @@
 #include <ranges>
 #include <benchmark.hpp>
 #include <bpl/utils/RandomUtils.hpp>
+#include <bpl/bank/SketchDistance.hpp>
 
 #include <tasks/VectorChecksum.hpp>
 #include <tasks/VectorChecksumOnce.hpp>
+#include <tasks/VectorSkewedCost.hpp>
 #include <tasks/VectorAdd.hpp>
 #include <tasks/VectorReverseInPlace.hpp>
 #include <tasks/SyracuseReduce.hpp>
@@ -89,6 +91,42 @@ TEST_CASE ("VectorChecksumOnce", "[benchmark]" )
     );
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// Skewed input: the cost of an item is its value and the first items are much more expensive
+// than the last ones => a split by count gives most of the work to the first process units.
+auto getSkewedLengths (uint64_t input)
+{
+    size_t n = 1UL<<input;
+    std::vector<uint32_t> v (n);
+    for (size_t i=0; i<n; i++)  {  v[i] = 1 + 4096 * (n-i) / n * (n-i) / n;  }
+    return v;
+}
+
+TEST_CASE ("VectorSkewedCost", "[benchmark]" )
+{
+    Benchmark::run (
+        getDefaultLaunchers(),
+        std::vector {14,16,18},
+        [] (auto&& launcher, uint64_t input, size_t nbruns) {
+            auto v = getSkewedLengths (input);
+            return Benchmark::run<VectorSkewedCost> (launcher, nbruns, false, split(v));
+        }
+    );
+}
+
+TEST_CASE ("VectorSkewedCostWeighted", "[benchmark]" )
+{
+    Benchmark::run (
+        getDefaultLaunchers(),
+        std::vector {14,16,18},
+        [] (auto&& launcher, uint64_t input, size_t nbruns) {
+            auto v = getSkewedLengths (input);
+            auto w = weighted (v, [] (uint32_t len) { return len; });
+            return Benchmark::run<VectorSkewedCost> (launcher, nbruns, false, split(w));
+        }
+    );
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //TEST_CASE ("VectorAdd", "[benchmark]" )
 //{
@@ -202,6 +240,69 @@ TEST_CASE ("SketchJaccardDistanceOnce", "[benchmark]" )
 	);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// All-vs-all comparison of N reference sketches with N query sketches: current task vs tiled engine.
+// The sketches are strictly increasing random values (like MinHash sketches), so that the merges
+// of two sketches have unpredictable branches.
+auto getAllVsAllSketches (size_t nbSketches, size_t ssize)
+{
+    using hash_t = SketchDistanceEngine::hash_t;
+
+    std::mt19937 rng (nbSketches);
+
+    auto generate = [&] ()
+    {
+        std::vector<hash_t> v;
+        for (size_t i=0; i<nbSketches; i++)
+        {
+            hash_t x = 0;
+            for (size_t j=0; j<ssize; j++)  {  x += 1 + rng()%8;  v.push_back (x);  }
+        }
+        return v;
+    };
+
+    auto ref = generate();
+    auto qry = generate();
+
+    return std::make_pair (ref, qry);
+}
+
+TEST_CASE ("SketchJaccardDistanceAllVsAll", "[benchmark]" )
+{
+    Benchmark::run (
+        std::make_tuple (getDefaultMulticoreView_pow2()),
+        std::vector {1'000, 10'000},
+        [] (auto&& launcher, uint64_t input, size_t nbruns) {
+            size_t SSIZE = 100;
+            auto [ref,qry] = getAllVsAllSketches (input, SSIZE);
+            return Benchmark::run<SketchJaccardDistance> (launcher, nbruns, false, split(ref), qry, SSIZE);
+        },
+        1
+    );
+}
+
+TEST_CASE ("SketchDistanceEngine", "[benchmark]" )
+{
+    Benchmark::run (
+        std::make_tuple (getDefaultMulticoreView_pow2()),
+        std::vector {1'000, 10'000},
+        [] (auto&& launcher, uint64_t input, size_t nbruns) {
+            size_t SSIZE = 100;
+            auto [ref,qry] = getAllVsAllSketches (input, SSIZE);
+
+            SketchDistanceEngine engine (SSIZE);
+            std::vector<SketchDistanceEngine::count_t> matrix (input*input);
+
+            auto compute = [&]  {  engine.compute (launcher, ref, qry, matrix);  };
+
+            Benchmark::warmup (compute, false);
+
+            return std::make_tuple (Benchmark::repeat (compute, nbruns), std::string_view("SketchDistanceEngine"));
+        },
+        1
+    );
+}
+
 //////////////////////////////////////////////////////////////////////////////
 TEST_CASE ("SortSelection", "[benchmark]" )
 {
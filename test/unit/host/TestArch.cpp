@@ -6,14 +6,120 @@
 
 #include <common.hpp>
 
+#include <numeric>
+
 using namespace bpl;
 
+#include <tasks/SyracuseReduce.hpp>
+#include <tasks/GetPuidSplit.hpp>
+
 ////////////////////////////////////////////////////////////////////////////////
 TEST_CASE ("MULTICORE: check properties", "[Arch]" )
 {
     REQUIRE (ArchMulticore().name() == "multicore");
     REQUIRE (ArchMulticore( ).getProcUnitNumber() ==  1);
     REQUIRE (ArchMulticore(8).getProcUnitNumber() ==  8);
+
+    // A configuration not built by 'make_configuration' is rejected.
+    REQUIRE_THROWS_AS (ArchMulticore (std::any (42)), std::bad_any_cast);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("MULTICORE: dynamic scheduling", "[Arch]" )
+{
+    auto range = std::pair<uint64_t,uint64_t> (1, 1<<14);
+
+    uint64_t truth = Launcher<ArchMulticore> {1_thread}.run<SyracuseReduce> (split(range));
+
+    for (size_t granularity : {1,2,8,33})
+    {
+        ArchMulticore arch (8_thread, 4_thread, false, false, granularity);
+        REQUIRE (arch.getGranularity() == granularity);
+
+        // One result per chunk, delivered in chunk order.
+        auto results = arch.run<SyracuseReduce> (split(range));
+        REQUIRE (results.size() == 8*granularity);
+        REQUIRE (arch.getStatistics().getCallNb("run/chunks") == 8*granularity);
+
+        uint64_t sum = 0;
+        for (size_t i=0; i<results.size(); i++)
+        {
+            auto r = SplitOperator<decltype(range)>::split (range, i, results.size());
+            REQUIRE (results[i] == SyracuseReduce<ArchMulticore>{} (r));
+            sum += results[i];
+        }
+        REQUIRE (sum == truth);
+
+        Launcher<ArchMulticore> launcher (8_thread, 4_thread, false, false, granularity);
+        REQUIRE (launcher.run<SyracuseReduce> (split(range)) == truth);
+
+        // The chunks of a process unit share its uid.
+        auto puids = arch.run<GetPuidSplit> (split(range));
+        REQUIRE (puids.size() == 8*granularity);
+        for (size_t i=0; i<puids.size(); i++)  {  REQUIRE (puids[i] == i/granularity);  }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+template<class ARCH>  struct NumaSum : bpl::Task<ARCH>
+{
+    USING(ARCH);
+    auto operator() (std::span<const uint64_t> v)  {  uint64_t s=0;  for (auto x : v)  { s+=x; }  return s;  }
+    static uint64_t reduce (uint64_t a, uint64_t b)  { return a+b; }
+};
+
+TEST_CASE ("MULTICORE: NUMA placement", "[Arch]" )
+{
+    std::vector<uint64_t> v (1<<18);
+    for (size_t i=0; i<v.size(); i++)  { v[i] = i; }
+    uint64_t truth = v.size()*(v.size()-1)/2;
+
+    for (auto mode : {NumaMode::NONE, NumaMode::COPY, NumaMode::MIGRATE})
+    {
+        ArchMulticore arch (8_thread, 4_thread, false, false, 3, mode);
+        REQUIRE (arch.getNumaMode() == mode);
+
+        Launcher<ArchMulticore> launcher (8_thread, 4_thread, false, false, 3, mode);
+        REQUIRE (launcher.run<NumaSum> (split(std::span<const uint64_t>{v})) == truth);
+
+        auto results = arch.run<NumaSum> (split(std::span<const uint64_t>{v}));
+        REQUIRE (std::accumulate (results.begin(), results.end(), uint64_t(0)) == truth);
+
+        auto const& stats = arch.getStatistics();
+        if (mode == NumaMode::NONE or Executor::instance().placement() == Placement::NONE)
+        {
+            // Unpinned workers have no known node -> nothing is placed.
+            REQUIRE (stats.getCallNb ("numa/bytes/local")  == 0);
+            REQUIRE (stats.getCallNb ("numa/bytes/remote") == 0);
+        }
+        else
+        {
+            // All the bytes are seen once, either local or remote.
+            REQUIRE (stats.getCallNb ("numa/bytes/local") + stats.getCallNb ("numa/bytes/remote") == v.size()*sizeof(uint64_t));
+            if (Executor::instance().topology().getNbNodes() == 1)  {  REQUIRE (stats.getCallNb ("numa/bytes/copied") == 0);  }
+        }
+    }
+
+    // A placer for another node than the one of the pages sees them as remote.
+    auto nodes = numa::getNodes (v.data(), v.size()*sizeof(uint64_t));
+    if (not nodes.empty() and nodes[0] >= 0)
+    {
+        numa::Counters counters;
+        numa::Placer placer (NumaMode::COPY, nodes[0]+1, counters);
+
+        std::span<const uint64_t> slice (v.data()+1000, 5000);
+        auto placed = placer.place (slice);
+
+        REQUIRE (placed.data() != slice.data());
+        REQUIRE (std::equal (placed.begin(), placed.end(), slice.begin(), slice.end()));
+        REQUIRE (counters.remote.load() == slice.size_bytes());
+        REQUIRE (counters.copied.load() == slice.size_bytes());
+        REQUIRE (counters.local .load() == 0);
+
+        // Not a view -> nothing to place.
+        std::vector<uint64_t> w {1,2,3};
+        REQUIRE (placer.place (w) == w);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <common.hpp>
+
+#include <bpl/utils/Arena.hpp>
+
+#include <thread>
+#include <mutex>
+#include <map>
+
+using namespace bpl;
+
+template<typename T>
+using arena_vector = std::vector<T, ArenaAllocator<T>>;
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Arena scope", "[Arena]" )
+{
+    auto const& arena = Arena::local();
+
+    // No scope -> the heap is used.
+    {
+        arena_vector<uint32_t> v (100, 1);
+        REQUIRE (not arena->owns (v.data()));
+    }
+
+    const uint32_t* first = nullptr;
+    {
+        Arena::Scope scope;
+
+        arena_vector<uint32_t> a (100);
+        first = a.data();
+
+        arena_vector<uint32_t> v;
+        for (uint32_t i=0; i<10000; i++)  {  v.push_back (i);  }
+        REQUIRE (arena->owns (v.data()));
+        REQUIRE (arena->getNbLive() == 2);
+
+        // Allocations larger than Arena::LARGE go to the heap.
+        arena_vector<char> large (Arena::LARGE+1);
+        REQUIRE (not arena->owns (large.data()));
+    }
+    REQUIRE (arena->getNbLive() == 0);
+
+    // Nothing is alive anymore -> the arena is reset when a new scope begins.
+    {
+        Arena::Scope scope;
+        arena_vector<uint32_t> v (100);
+        REQUIRE (v.data() == first);
+
+        // Nested scopes don't reset the arena.
+        Arena::Scope nested;
+        arena_vector<uint32_t> w (100);
+        REQUIRE (w.data() != v.data());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Arena escaping memory", "[Arena]" )
+{
+    auto const& arena = Arena::local();
+
+    // A vector escapes from its scope: the arena must not be reset while it is alive.
+    auto make = [] (size_t n)
+    {
+        Arena::Scope scope;
+        arena_vector<uint64_t> v (n);
+        for (size_t i=0; i<n; i++)  {  v[i] = i*i;  }
+        return v;
+    };
+
+    auto v = make (1000);
+    REQUIRE (arena->owns (v.data()));
+    REQUIRE (arena->getNbLive() == 1);
+
+    auto w = make (1000);
+    for (size_t i=0; i<v.size(); i++)  {  REQUIRE (v[i] == i*i);  }
+
+    // A copy doesn't keep the arena.
+    arena_vector<uint64_t> copy = v;
+    REQUIRE (not arena->owns (copy.data()));
+
+    // The memory can be released by another thread.
+    std::thread ([&] { v = arena_vector<uint64_t>();  w = arena_vector<uint64_t>(); }).join();
+    REQUIRE (arena->getNbLive() == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+template<class ARCH>
+struct ArenaTask : bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    auto operator() (vector_view<uint32_t> const& v)
+    {
+        // Scratch vector of the task -> allocated in the arena of the worker.
+        vector<uint32_t,arena_allocator<uint32_t>> tmp;
+        for (auto x : v)  {  if (x%3==0)  { tmp.push_back (x); }  }
+
+        vector<uint32_t,arena_allocator<uint32_t>> result;
+        for (auto x : tmp)  {  result.push_back (x/3);  }
+        return result;
+    }
+
+    static auto reduce (vector<uint32_t,arena_allocator<uint32_t>> a, vector<uint32_t,arena_allocator<uint32_t>> const& b)
+    {
+        a.insert (a.end(), b.begin(), b.end());
+        return a;
+    }
+};
+
+TEST_CASE ("Arena multicore", "[Arena]" )
+{
+    std::vector<uint32_t> v (100000);
+    for (size_t i=0; i<v.size(); i++)  {  v[i] = i;  }
+
+    std::vector<uint32_t> truth;
+    for (auto x : v)  {  if (x%3==0)  { truth.push_back (x/3); }  }
+
+    Launcher<ArchMulticore> launcher (8_thread, 4_thread, false, false, 4);
+
+    // The results of previous runs must stay valid while the next runs use the arenas.
+    std::vector<decltype(launcher.run<ArenaTask> (split(v)))> results;
+    for (size_t i=0; i<5; i++)  {  results.push_back (launcher.run<ArenaTask> (split(v)));  }
+
+    for (auto const& res : results)
+    {
+        REQUIRE (std::equal (res.begin(), res.end(), truth.begin(), truth.end()));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::mutex                   arenasMutex;
+std::map<Arena*,std::size_t> arenasChunks;   // number of chunks of the worker arenas when first seen
+
+template<class ARCH>
+struct ArenaEscape : bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    auto operator() (size_t n)
+    {
+        {
+            std::lock_guard<std::mutex> lock (arenasMutex);
+            arenasChunks.emplace (Arena::local().get(), Arena::local()->getNbChunks());
+        }
+
+        vector<uint64_t,arena_allocator<uint64_t>> result;
+        result.reserve (n);
+        for (size_t i=0; i<n; i++)  {  result.push_back (i);  }
+        return result;
+    }
+};
+
+TEST_CASE ("Arena escaping results", "[Arena]" )
+{
+    ArchMulticore arch (1_thread);
+
+    // Each result escapes from the arena of its worker (the partial results are moved out of the
+    // tasks) and is alive during the next run: the arenas must reuse the chunks released by the
+    // previous results instead of growing (about 500MB here).
+    size_t n = 1<<15;
+    auto result = arch.run<ArenaEscape> (n);
+    for (size_t i=0; i<2000; i++)  {  result = arch.run<ArenaEscape> (n);  }
+
+    REQUIRE (result.size() == 1);
+    REQUIRE (result[0].size() == n);
+    REQUIRE (std::any_of (arenasChunks.begin(), arenasChunks.end(), [&] (auto const& x) { return x.first->owns (result[0].data()); }));
+
+    // A few chunks may be needed for the first results, the chunks of 1MB and more being enough.
+    REQUIRE (not arenasChunks.empty());
+    for (auto [arena,nb] : arenasChunks)  {  REQUIRE (arena->getNbChunks() <= std::max (nb, std::size_t(5)) + 1);  }
+}
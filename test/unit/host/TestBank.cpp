@@ -18,6 +18,12 @@
 #include <tasks/Bank3.hpp>
 #include <tasks/Bank4.hpp>
 #include <tasks/Bank5.hpp>
+#include <tasks/BankFastaCount.hpp>
+#include <tasks/Compare1.hpp>
+#include <tasks/ComparePacked.hpp>
+
+#include <filesystem>
+#include <fstream>
 
 using namespace bpl;
 
@@ -177,3 +183,224 @@ TEST_CASE ("BankChunk1", "[Bank]" )
 //    auto buffer = Serializer::to (bankOut);
 
 }
+
+//////////////////////////////////////////////////////////////////////////////
+// We generate a FASTA/FASTQ file with sequences of different sizes and return the truth
+// as (id,nucleotides) pairs.
+auto generateBank (const std::string& filename, bool fastq, size_t nbSequences, size_t lineSize, const std::string& header)
+{
+    std::vector<std::pair<std::string,std::string>> truth;
+
+    std::ofstream file (filename);
+
+    file << header;
+
+    RandomSequenceGenerator<64> generator;
+
+    for (size_t i=0; i<nbSequences; i++, ++generator)
+    {
+        std::string id  = "seq" + std::to_string(i) + " some comment";
+        std::string seq;
+        for (size_t n=0; n < 1 + (i*37)%200; n++)  {  seq += (*generator).data[n%64];  }
+
+        truth.push_back ({id,seq});
+
+        if (fastq)
+        {
+            // Quality lines may begin with '@', which makes the split harder.
+            file << "@" << id << "\n" << seq << "\n+\n" << "@" << std::string(seq.size()-1,'I') << "\n";
+        }
+        else
+        {
+            file << ">" << id << "\n";
+            for (size_t k=0; k<seq.size(); k+=lineSize)  {  file << seq.substr(k,lineSize) << "\n";  }
+        }
+    }
+
+    return truth;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void BankFasta_aux (bool fastq, size_t nbSequences, size_t lineSize, const std::string& header="")
+{
+    // The file name is unique, so that test processes run in parallel don't share it.
+    std::string filename = std::filesystem::temp_directory_path() / fmt::format ("bpl_test_bank_{}.fa", getpid());
+
+    auto truth = generateBank (filename, fastq, nbSequences, lineSize, header);
+
+    BankFasta bank (filename);
+
+    REQUIRE (bank.isFastq() == (fastq and nbSequences>0));
+
+    // Whole bank iteration.
+    size_t nb=0;
+    bank.iterate ([&] (size_t idx, const SequenceRecord& record)
+    {
+        REQUIRE (idx == nb);
+        REQUIRE (record.id   == truth[idx].first);
+        REQUIRE (record.data == truth[idx].second);
+        REQUIRE (record.quality.size() == (fastq ? record.data.size() : 0));
+        nb++;
+    });
+    REQUIRE (nb == truth.size());
+
+    // The split parts partition the records of the bank, in the same order.
+    for (size_t total : {1,2,3,7,16,100,1000})
+    {
+        size_t k=0;
+        for (size_t idx=0; idx<total; idx++)
+        {
+            for (auto&& record : SplitOperator<BankFasta>::split (bank, idx, total))
+            {
+                REQUIRE (k < truth.size());
+                REQUIRE (record.id   == truth[k].first);
+                REQUIRE (record.data == truth[k].second);
+                k++;
+            }
+        }
+        REQUIRE (k == truth.size());
+    }
+
+    // Split bank on the multicore architecture.
+    uint64_t nbNucleotides = 0;
+    for (auto&& x : truth)  { nbNucleotides += x.second.size(); }
+
+    for (size_t nbThreads : {1,2,3,8})
+    {
+        Launcher<ArchMulticore> launcher {ArchMulticore::Thread{nbThreads}};
+
+        auto result = launcher.run<BankFastaCount> (split(bank));
+
+        REQUIRE (result.first  == truth.size());
+        REQUIRE (result.second == nbNucleotides);
+    }
+
+    std::filesystem::remove (filename);
+}
+
+TEST_CASE ("BankFasta", "[Bank]" )
+{
+    for (size_t nbSequences : {0,1,2,10,1000})
+    {
+        BankFasta_aux (true,  nbSequences, 0);
+
+        for (size_t lineSize : {60,1000})  {  BankFasta_aux (false, nbSequences, lineSize);  }
+
+        // The format is detected after leading blank lines and comments.
+        BankFasta_aux (true,  nbSequences, 0,  "\n  \n# some comment\n");
+        BankFasta_aux (false, nbSequences, 60, "\r\n\n; some comment\n\n");
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+template<std::size_t S>
+void PackedSequence_aux ()
+{
+    static_assert (sizeof(PackedSequence<S>) == 8*((S+31)/32));
+
+    RandomSequenceGenerator<S> generator;
+
+    for (size_t n=0; n<20; n++)
+    {
+        Sequence<S> a = *generator;  ++generator;
+        Sequence<S> b = *generator;  ++generator;
+
+        // Some common nucleotides between a and b
+        for (size_t i=0; i<S; i+=3)  {  b.data[i] = a.data[i];  }
+
+        PackedSequence<S> pa (a);
+        PackedSequence<S> pb (b);
+
+        size_t hamming = 0;
+        for (size_t i=0; i<S; i++)
+        {
+            REQUIRE (pa[i] == a.data[i]);
+            hamming += a.data[i]!=b.data[i] ? 1 : 0;
+        }
+
+        REQUIRE (PackedSequence<S>::hamming  (pa,pb) == hamming);
+        REQUIRE (PackedSequence<S>::nbCommon (pa,pb) == S-hamming);
+        REQUIRE (PackedSequence<S>::hamming  (pa,pa) == 0);
+
+        auto rc = pa.reverseComplement();
+        for (size_t i=0; i<S; i++)
+        {
+            auto c = a.data[S-1-i];
+            REQUIRE (rc[i] == (c=='A' ? 'T' : c=='T' ? 'A' : c=='C' ? 'G' : 'C'));
+        }
+        REQUIRE (rc.reverseComplement() == pa);
+
+        // Same thing with N nucleotides.
+        std::string sa ((char*)a.data, S);
+        std::string sb ((char*)b.data, S);
+        for (size_t i=0; i<S; i+=7)  {  sa[i] = 'N';  }
+        for (size_t i=0; i<S; i+=5)  {  sb[i] = 'n';  }
+
+        PackedSequence<S,true> na (sa.data());
+        PackedSequence<S,true> nb (sb.data());
+
+        size_t hammingN = 0;
+        for (size_t i=0; i<S; i++)
+        {
+            REQUIRE (na[i] == sa[i]);
+            hammingN += (sa[i]=='N' or sb[i]=='n' or sa[i]!=sb[i]) ? 1 : 0;
+        }
+        REQUIRE (PackedSequence<S,true>::hamming (na,nb) == hammingN);
+
+        auto rcN = na.reverseComplement();
+        for (size_t i=0; i<S; i++)
+        {
+            auto c = sa[S-1-i];
+            REQUIRE (rcN[i] == (c=='N' ? 'N' : c=='A' ? 'T' : c=='T' ? 'A' : c=='C' ? 'G' : 'C'));
+        }
+        REQUIRE (rcN.reverseComplement() == na);
+    }
+}
+
+TEST_CASE ("PackedSequence", "[Bank]" )
+{
+    PackedSequence_aux<1>   ();
+    PackedSequence_aux<7>   ();
+    PackedSequence_aux<31>  ();
+    PackedSequence_aux<32>  ();
+    PackedSequence_aux<33>  ();
+    PackedSequence_aux<64>  ();
+    PackedSequence_aux<100> ();
+    PackedSequence_aux<150> ();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("ComparePacked", "[Bank]" )
+{
+    using arch_t = ArchMulticore;
+
+    const static int SEQLEN = ComparePacked<arch_t>::SEQLEN;
+    const static int NBREF  = ComparePacked<arch_t>::NBREF;
+    const static int NBQRY  = ComparePacked<arch_t>::NBQRY;
+
+    using packed_t = ComparePacked<arch_t>::sequence_t;
+
+    RandomSequenceGenerator<SEQLEN> generator;
+
+    BankChunk <arch_t,SEQLEN,NBREF> ref (generator);
+    BankChunk <arch_t,SEQLEN,NBQRY> qry (generator);
+
+    BankChunk <arch_t,SEQLEN,NBREF,packed_t> refPacked;
+    BankChunk <arch_t,SEQLEN,NBQRY,packed_t> qryPacked;
+    for (size_t i=0; i<ref.size(); i++)  {  refPacked.sequences_[i] = ref.sequences_[i];  }
+    for (size_t i=0; i<qry.size(); i++)  {  qryPacked.sequences_[i] = qry.sequences_[i];  }
+
+    // 4 times less data to be broadcasted.
+    static_assert (4*sizeof(refPacked) == sizeof(ref));
+
+    std::pair<int,int> range = {0, NBQRY};
+
+    Launcher<ArchMulticore> launcher {ArchMulticore::Thread{4}};
+
+    for (size_t threshold : {0, 20, 30, 50})
+    {
+        auto truth  = launcher.run<Compare1>      (ref,       qry,       split(range), threshold);
+        auto result = launcher.run<ComparePacked> (refPacked, qryPacked, split(range), threshold);
+        REQUIRE (result == truth);
+    }
+}
@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <common.hpp>
+
+#include <bpl/utils/Topology.hpp>
+#include <bpl/utils/Executor.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <list>
+
+using namespace bpl;
+
+#include <tasks/SyracuseReduce.hpp>
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Topology", "[Executor]" )
+{
+    auto topo = Topology::read();
+
+    REQUIRE (topo.getNbCpus()    >= 1);
+    REQUIRE (topo.getNbCores()   >= 1);
+    REQUIRE (topo.getNbSockets() >= 1);
+    REQUIRE (topo.getNbNodes()   >= 1);
+    REQUIRE (topo.getNbCores()   <= topo.getNbCpus());
+
+    // Each policy gives a permutation of the CPUs.
+    auto ids = [] (auto const& cpus)
+    {
+        std::vector<int> result;
+        for (auto const& c : cpus)  { result.push_back (c.id); }
+        std::sort (result.begin(), result.end());
+        return result;
+    };
+
+    for (auto policy : {Placement::NONE, Placement::COMPACT, Placement::SCATTER})
+    {
+        REQUIRE (ids (topo.order(policy)) == ids (topo.cpus()));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Topology fake tree", "[Executor]" )
+{
+    // 2 sockets x 2 cores x 2 SMT, with the Linux numbering (the second SMT siblings come last)
+    // and one NUMA node per socket.
+    namespace fs = std::filesystem;
+
+    fs::path root = fs::temp_directory_path() / fmt::format ("bpl_topology_{}", getpid());
+
+    auto write = [] (const fs::path& path, const std::string& content)
+    {
+        fs::create_directories (path.parent_path());
+        std::ofstream (path) << content << "\n";
+    };
+
+    write (root / "cpu" / "online", "0-7");
+
+    for (int id=0; id<8; id++)
+    {
+        fs::path dir = root / "cpu" / fmt::format ("cpu{}", id) / "topology";
+        write (dir / "physical_package_id",  std::to_string ((id%4)/2));
+        write (dir / "core_id",              std::to_string (id%2));
+        write (dir / "thread_siblings_list", fmt::format ("{},{}", id%4, id%4+4));
+    }
+
+    write (root / "node" / "online",             "0-1");
+    write (root / "node" / "node0" / "cpulist",  "0-1,4-5");
+    write (root / "node" / "node1" / "cpulist",  "2-3,6-7");
+
+    auto topo = Topology::read ((root / "cpu").string(), false);
+
+    fs::remove_all (root);
+
+    REQUIRE (topo.getNbCpus()    == 8);
+    REQUIRE (topo.getNbCores()   == 4);
+    REQUIRE (topo.getNbSockets() == 2);
+    REQUIRE (topo.getNbNodes()   == 2);
+
+    auto ids = [] (auto const& cpus)
+    {
+        std::vector<int> result;
+        for (auto const& c : cpus)  { result.push_back (c.id); }
+        return result;
+    };
+
+    REQUIRE (ids (topo.order (Placement::COMPACT)) == std::vector<int> {0,4,1,5,2,6,3,7});
+    REQUIRE (ids (topo.order (Placement::SCATTER)) == std::vector<int> {0,2,1,3,4,6,5,7});
+
+    for (auto const& c : topo.cpus())  {  REQUIRE (c.node == c.socket);  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Executor sequence", "[Executor]" )
+{
+    auto& executor = Executor::instance();
+    REQUIRE (executor.size() >= 1);
+
+    // The workers are pinned only on request.
+    if (getenv ("BPL_PLACEMENT") == nullptr)  {  REQUIRE (executor.placement() == Placement::NONE);  }
+
+    for (size_t concurrency : {1, 3, 16})
+    {
+        auto lease = executor.lease (concurrency);
+
+        std::atomic<size_t> running = 0;
+        std::atomic<size_t> maxRunning = 0;
+
+        auto results = lease.submit_sequence<size_t> (0, 1000, [&] (size_t i)
+        {
+            size_t n = ++running;
+            for (size_t m = maxRunning; m<n and not maxRunning.compare_exchange_weak (m,n); )  {}
+            running--;
+            return i*i;
+        }).get();
+
+        REQUIRE (results.size() == 1000);
+        for (size_t i=0; i<results.size(); i++)  {  REQUIRE (results[i] == i*i);  }
+
+        REQUIRE (maxRunning.load() <= concurrency);
+    }
+
+    // An exception thrown by a job is rethrown by 'get'.
+    auto lease = executor.lease (4);
+    auto future = lease.submit_sequence<int> (0, 100, [] (int i)
+    {
+        if (i==42)  { throw std::runtime_error ("job failed"); }
+        return i;
+    });
+    REQUIRE_THROWS_AS (future.get(), std::runtime_error);
+
+    // An exception thrown by a detached job is rethrown by the 'wait' of the lease, once.
+    std::atomic<size_t> nbDone = 0;
+    for (size_t i=0; i<20; i++)
+    {
+        lease.detach_task ([i,&nbDone]
+        {
+            if (i==7)  { throw std::runtime_error ("detached job failed"); }
+            nbDone++;
+        });
+    }
+    REQUIRE_THROWS_AS (lease.wait(), std::runtime_error);
+    REQUIRE (nbDone.load() == 19);
+    REQUIRE_NOTHROW (lease.wait());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Executor nested", "[Executor]" )
+{
+    auto& executor = Executor::instance();
+
+    // Each job waits for a sequence submitted on another lease: the waiting workers execute the
+    // jobs of this sequence themselves, so there is no deadlock even with more jobs than workers.
+    auto outer = executor.lease (4*executor.size());
+
+    auto results = outer.submit_sequence<size_t> (0, 4*executor.size(), [&] (size_t i)
+    {
+        auto inner = executor.lease (2).submit_sequence<size_t> (0, 100, [] (size_t j) { return j; }).get();
+        return std::accumulate (inner.begin(), inner.end(), size_t(0)) + i;
+    }).get();
+
+    for (size_t i=0; i<results.size(); i++)  {  REQUIRE (results[i] == 4950+i);  }
+
+    // Same thing with launchers: the tasks of a pool of multicore launchers are run by the same workers.
+    auto range = std::pair<uint64_t,uint64_t> (1, 1<<12);
+    uint64_t truth = Launcher<ArchMulticore> {1_thread}.run<SyracuseReduce> (split(range));
+
+    std::atomic<uint64_t> total = 0;
+    auto cbk = [&total] (auto&& launcher, auto&& result)  {  total += result;  };
+
+    LauncherPool<ArchMulticore> pool (3, 8_thread);
+    for (size_t i=0; i<10; i++)  {  pool.submit<SyracuseReduce> (cbk, split(range));  }
+    pool.wait();
+
+    REQUIRE (total.load() == 10*truth);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Executor shared by launchers", "[Executor]" )
+{
+    auto& executor = Executor::instance();
+    size_t nbWorkers = executor.size();
+
+    auto range = std::pair<uint64_t,uint64_t> (1, 1<<12);
+    uint64_t truth = Launcher<ArchMulticore> {1_thread}.run<SyracuseReduce> (split(range));
+
+    // Many launchers don't create any thread.
+    std::list<Launcher<ArchMulticore>> launchers;
+    for (size_t i=0; i<50; i++)  {  launchers.emplace_back (64_thread);  }
+
+    for (auto& launcher : launchers)  {  REQUIRE (launcher.run<SyracuseReduce> (split(range)) == truth);  }
+
+    REQUIRE (executor.size() == nbWorkers);
+}
@@ -6,6 +6,8 @@
 
 #include <common.hpp>
 
+#include <set>
+
 using namespace bpl;
 
 #include <tasks/Parrot1.hpp>
@@ -31,6 +33,10 @@ using namespace bpl;
 #include <tasks/LauncherPool1.hpp>
 #include <tasks/Max.hpp>
 #include <tasks/Min.hpp>
+#include <tasks/ReduceOrdered.hpp>
+#include <tasks/ReduceMin.hpp>
+#include <tasks/VectorChecksum.hpp>
+#include <tasks/Exception1.hpp>
 
 //////////////////////////////////////////////////////////////////////////////
 struct config
@@ -585,8 +591,272 @@ TEST_CASE ("LauncherPool2", "[Launcher]" )
     // For the left reference:   1 default
     REQUIRE (LauncherPoolTest<true> ::stats() == std::array<size_t,4> {1,0,0,1});
 
-    // For the temporary object: 1 default, 1 copy and 2 moves
-    REQUIRE (LauncherPoolTest<false>::stats() == std::array<size_t,4> {1,1,2,4});
+    // For the temporary object: 1 default and 2 moves (no copy)
+    REQUIRE (LauncherPoolTest<false>::stats() == std::array<size_t,4> {1,0,2,3});
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Keeps the launcher of a pool busy until it is opened.
+struct LauncherPoolGate
+{
+    mutable std::atomic<bool> started = false;
+    mutable std::atomic<bool> opened  = false;
+
+    void wait() const  {  while (not started)  { std::this_thread::yield(); }  }
+};
+
+template<class ARCH>  struct LauncherPoolBlock : bpl::Task<ARCH>
+{
+    USING(ARCH);
+    auto operator() (LauncherPoolGate const& gate) const
+    {
+        gate.started = true;
+        while (not gate.opened)  {  std::this_thread::yield();  }
+        return 0;
+    }
+};
+
+// Batched task: one result per query.
+template<class ARCH>  struct LauncherPoolSquare : bpl::Task<ARCH>
+{
+    USING(ARCH);
+    static auto& nbCalls()  {  static std::atomic<size_t> nb = 0;  return nb;  }
+
+    auto operator() (vector_view<uint32_t> const& queries) const
+    {
+        nbCalls()++;
+        vector<uint64_t> result;
+        for (auto q : queries)  {  result.push_back (uint64_t(q)*q);  }
+        return result;
+    }
+};
+
+TEST_CASE ("LauncherPoolCoalescing", "[Launcher]" )
+{
+    using task_t = LauncherPoolSquare<ArchMulticore>;
+
+    for (size_t maxBatchSize : {0, 30})
+    {
+        LauncherPool<ArchMulticore> pool (1, 4_thread);
+        pool.setMaxBatchSize (maxBatchSize);
+
+        LauncherPoolGate gate;
+        pool.submit<LauncherPoolBlock> ([] (auto&& launcher, auto&& results) {}, std::ref(gate));
+        gate.wait();
+
+        task_t::nbCalls() = 0;
+
+        size_t nbQueries = 100;
+        std::vector<uint64_t> results (nbQueries, 0);
+
+        // The queries wait for the launcher -> they are coalesced.
+        for (uint32_t i=0; i<nbQueries; i++)
+        {
+            pool.submit_query<LauncherPoolSquare> ([&results,i] (auto&& launcher, uint64_t res) {  results[i] = res;  }, i);
+        }
+        REQUIRE (pool.getNbPending() == nbQueries);
+
+        gate.opened = true;
+        pool.wait();
+
+        REQUIRE (pool.getNbPending() == 0);
+        for (uint32_t i=0; i<nbQueries; i++)  {  REQUIRE (results[i] == uint64_t(i)*i);  }
+
+        // One run per batch, each one calling the task once per thread.
+        size_t nbBatches = maxBatchSize==0 ? 1 : (nbQueries + maxBatchSize - 1) / maxBatchSize;
+        REQUIRE (task_t::nbCalls() == 4*nbBatches);
+    }
+}
+
+TEST_CASE ("LauncherPoolCoalescingException", "[Launcher]" )
+{
+    // The queries of a batch whose callbacks throw: the other callbacks are called anyway.
+    for (std::set<uint32_t> failing : std::vector<std::set<uint32_t>> { {3}, {3,7} })
+    {
+        LauncherPool<ArchMulticore> pool (1, 2_thread);
+
+        LauncherPoolGate gate;
+        pool.submit<LauncherPoolBlock> ([] (auto&& launcher, auto&& results) {}, std::ref(gate));
+        gate.wait();
+
+        size_t nbQueries = 10;
+        std::vector<uint64_t> results (nbQueries, 0);
+        for (uint32_t i=0; i<nbQueries; i++)
+        {
+            pool.submit_query<LauncherPoolSquare> ([&results,&failing,i] (auto&& launcher, uint64_t res)
+            {
+                if (failing.contains(i))  {  throw std::logic_error ("callback failed");  }
+                results[i] = res;
+            }, i);
+        }
+
+        gate.opened = true;
+
+        // A single error is rethrown as is; several ones are reported together.
+        if (failing.size()==1)  {  REQUIRE_THROWS_AS (pool.wait(), std::logic_error);    }
+        else                    {  REQUIRE_THROWS_AS (pool.wait(), std::runtime_error);  }
+
+        for (uint32_t i=0; i<nbQueries; i++)  {  REQUIRE (results[i] == (failing.contains(i) ? 0 : uint64_t(i)*i));  }
+    }
+}
+
+TEST_CASE ("LauncherPoolPriority", "[Launcher]" )
+{
+    LauncherPool<ArchMulticore> pool (1, 1_thread);
+
+    LauncherPoolGate gate;
+    pool.submit<LauncherPoolBlock> ([] (auto&& launcher, auto&& results) {}, std::ref(gate));
+    gate.wait();
+
+    // Only one launcher -> the callbacks are called one at a time.
+    std::vector<uint16_t> order;
+    auto cbk = [&order] (auto&& launcher, auto&& results)  {  order.push_back (results[0]);  };
+
+    pool.submit<LauncherPool1> (Priority::LOW,    cbk, uint16_t(1));
+    pool.submit<LauncherPool1> (                  cbk, uint16_t(2));
+    pool.submit<LauncherPool1> (Priority::HIGH,   cbk, uint16_t(3));
+    pool.submit<LauncherPool1> (Priority::NORMAL, cbk, uint16_t(4));
+    pool.submit<LauncherPool1> (Priority::HIGH,   cbk, uint16_t(5));
+
+    gate.opened = true;
+    pool.wait();
+
+    REQUIRE (order == std::vector<uint16_t> {3, 5, 2, 4, 1});
+}
+
+TEST_CASE ("LauncherPoolBackpressure", "[Launcher]" )
+{
+    LauncherPool<ArchMulticore> pool (1, 1_thread);
+    pool.setMaxPending (2);
+
+    LauncherPoolGate gate;
+    pool.submit<LauncherPoolBlock> ([] (auto&& launcher, auto&& results) {}, std::ref(gate));
+    gate.wait();
+
+    std::atomic<size_t> nbSubmitted = 0;
+    std::atomic<size_t> nbDone      = 0;
+
+    std::thread producer ([&]
+    {
+        for (uint16_t i=0; i<5; i++)
+        {
+            pool.submit<LauncherPool1> ([&nbDone] (auto&& launcher, auto&& results)  {  nbDone++;  }, i);
+            nbSubmitted++;
+        }
+    });
+
+    // The producer is blocked once two submissions are pending.
+    while (nbSubmitted < 2)  {  std::this_thread::yield();  }
+    std::this_thread::sleep_for (std::chrono::milliseconds(50));
+    REQUIRE (nbSubmitted  == 2);
+    REQUIRE (pool.getNbPending() == 2);
+
+    gate.opened = true;
+    producer.join();
+    pool.wait();
+
+    REQUIRE (nbDone == 5);
+}
+
+template<class ARCH>  struct LauncherPoolThrow : bpl::Task<ARCH>
+{
+    USING(ARCH);
+    auto operator() (uint16_t n) const
+    {
+        if (n==3)  {  throw std::runtime_error ("task failed");  }
+        return n;
+    }
+};
+
+// Argument counting its copies.
+struct LauncherPoolCounted
+{
+    static auto& nbCopies()  {  static std::atomic<size_t> nb = 0;  return nb;  }
+
+    uint16_t value = 0;
+
+    LauncherPoolCounted (uint16_t v) : value(v)  {}
+    LauncherPoolCounted (const LauncherPoolCounted& other) : value(other.value)  {  nbCopies()++;  }
+    LauncherPoolCounted (LauncherPoolCounted&&) = default;
+};
+
+template<class ARCH>  struct LauncherPoolCopy : bpl::Task<ARCH>
+{
+    USING(ARCH);
+    auto operator() (LauncherPoolCounted const& x) const  {  return x.value;  }
+};
+
+TEST_CASE ("LauncherPoolArguments", "[Launcher]" )
+{
+    LauncherPool<ArchMulticore> pool (2, 2_thread);
+
+    std::atomic<size_t> total = 0;
+    auto cbk = [&total] (auto&& launcher, auto&& results)  {  for (auto r : results)  { total += r; }  };
+
+    // The arguments provided as rvalues are moved into the pending submissions, not copied.
+    LauncherPoolCounted::nbCopies() = 0;
+    for (uint16_t n=0; n<10; n++)  {  pool.submit<LauncherPoolCopy> (cbk, LauncherPoolCounted {n});  }
+    pool.wait();
+
+    REQUIRE (total == 2*45);
+    REQUIRE (LauncherPoolCounted::nbCopies() == 0);
+
+    // The lvalues are copied once (the submission keeps its own arguments).
+    LauncherPoolCounted x {3};
+    pool.submit<LauncherPoolCopy> (cbk, x);
+    pool.wait();
+    REQUIRE (LauncherPoolCounted::nbCopies() == 1);
+}
+
+TEST_CASE ("LauncherPoolException", "[Launcher]" )
+{
+    LauncherPool<ArchMulticore> pool (2, 2_thread);
+
+    std::atomic<size_t> nbDone = 0;
+    auto cbk = [&nbDone] (auto&& launcher, auto&& results)  {  nbDone++;  };
+
+    // The other submissions are run and the error is rethrown by 'wait'.
+    for (uint16_t n=0; n<10; n++)  {  pool.submit<LauncherPoolThrow> (cbk, n);  }
+    REQUIRE_THROWS_AS (pool.wait(), std::runtime_error);
+    REQUIRE (nbDone == 9);
+
+    // Same thing for a callback.
+    pool.submit<LauncherPool1> ([] (auto&& launcher, auto&& results)  {  throw std::logic_error ("callback failed");  }, uint16_t(1));
+    REQUIRE_THROWS_AS (pool.wait(), std::logic_error);
+
+    // The launchers have been given back and the error has been reported once.
+    nbDone = 0;
+    for (uint16_t n=0; n<10; n++)  {  pool.submit<LauncherPool1> (cbk, n);  }
+    REQUIRE_NOTHROW (pool.wait());
+    REQUIRE (nbDone == 10);
+}
+
+TEST_CASE ("LauncherPoolWarmup", "[Launcher]" )
+{
+    auto hasTiming = [] (auto const& stats, std::string const& key)  {  return stats.getTimings().contains(key);  };
+
+    LauncherPool<ArchMulticore> pool (3, 2_thread);
+    REQUIRE (not hasTiming (pool.getStatistics(), "startup/launcher/0"));
+
+    // All the launchers are created (and the task preloaded) before the first submission.
+    pool.warmup<LauncherPool1>();
+
+    for (size_t i=0; i<pool.size(); i++)
+    {
+        REQUIRE (hasTiming (pool.getStatistics(), "startup/launcher/" + std::to_string(i)));
+        REQUIRE (hasTiming (pool.getStatistics(), "startup/preload/"  + std::to_string(i)));
+    }
+    REQUIRE (hasTiming (pool.getStatistics(), "startup/warmup"));
+
+    std::atomic<size_t> total = 0;
+    for (uint16_t n=0; n<10; n++)
+    {
+        pool.submit<LauncherPool1> ([&total] (auto&& launcher, auto&& results)  {  for (auto r : results)  { total += r; }  }, n);
+    }
+    pool.wait();
+
+    REQUIRE (total == 2*45);
+    REQUIRE (pool.getStatistics().getTimings().size() == 2*pool.size()+1);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -617,3 +887,157 @@ TEST_CASE ("Min2", "[MaxMin]" )
     for (auto r : launcher.run<Min> (17, 42))  {  REQUIRE (r == 17);  }
     for (auto r : launcher.run<Min> (36, 12))  {  REQUIRE (r == 12);  }
 }
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("ReduceOrdered", "[Launcher]" )
+{
+    for (size_t nbunits : {1, 10, 63, 64, 65, 500, 1024})
+    {
+        Launcher<ArchMulticore> launcher (ArchMulticore::Thread(nbunits), 8_thread);
+
+        auto result = launcher.run<ReduceOrdered> ();
+
+        REQUIRE (result.size() == nbunits);
+        for (size_t i=0; i<result.size(); i++)  {  REQUIRE (result[i] == i);  }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("ReduceNoIdentity", "[Launcher]" )
+{
+    for (size_t nbunits : {1, 10, 63, 64, 65, 500, 1024})
+    {
+        Launcher<ArchMulticore> launcher (ArchMulticore::Thread(nbunits), 8_thread);
+
+        REQUIRE (launcher.run<ReduceMin> () == 1);
+
+        std::vector<uint32_t> results (nbunits);
+        for (size_t i=0; i<nbunits; i++)  {  results[i] = nbunits-i;  }
+        REQUIRE (Reduce<true,ReduceMin<ArchMulticore>>{} (results) == 1);
+
+        OrderedReducer<ReduceMin<ArchMulticore>> reducer;
+        launcher.stream<ReduceMin> (reducer);
+        REQUIRE (reducer.get() == 1);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Stream", "[Launcher]" )
+{
+    for (size_t nbunits : {1, 10, 100, 1000})
+    {
+        Launcher<ArchMulticore> launcher (ArchMulticore::Thread(nbunits), 8_thread);
+
+        // Each unit result is provided once. The sink runs on the workers, so the results are
+        // only collected there (the calls are serialized) and checked on the main thread.
+        std::vector<std::pair<size_t,std::vector<uint32_t>>> received;
+        launcher.stream<ReduceOrdered> ([&] (size_t idx, auto&& result)
+        {
+            received.emplace_back (idx, std::move(result));
+        });
+
+        REQUIRE (received.size() == nbunits);
+        std::vector<size_t> seen (nbunits, 0);
+        for (auto&& [idx,result] : received)
+        {
+            REQUIRE (idx < nbunits);
+            REQUIRE (result.size() == 1);
+            REQUIRE (result[0] == idx);
+            seen[idx]++;
+        }
+        for (auto n : seen)  {  REQUIRE (n==1);  }
+
+        // The reduction done on the fly keeps the units order.
+        OrderedReducer<ReduceOrdered<ArchMulticore>> reducer;
+        launcher.stream<ReduceOrdered> (reducer);
+
+        REQUIRE (reducer.size()    == nbunits);
+        REQUIRE (reducer.pending() == 0);
+        REQUIRE (reducer.maxPending() < nbunits);
+        REQUIRE (reducer.get()     == launcher.run<ReduceOrdered>());
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Multicore architecture executing one run at a time (like a PIM device).
+struct ArchMulticoreSerial : ArchMulticore
+{
+    using ArchMulticore::ArchMulticore;
+    static constexpr bool concurrent_runs = false;
+};
+
+TEST_CASE ("RunAsync", "[Launcher]" )
+{
+    size_t n = 1<<16;
+
+    std::vector<std::vector<uint32_t>> inputs (10);
+    std::vector<uint64_t> truths;
+    for (size_t k=0; k<inputs.size(); k++)
+    {
+        uint64_t truth = 0;
+        for (size_t i=1; i<=n; i++)  {  inputs[k].push_back (i*(k+1));  truth += i*(k+1);  }
+        truths.push_back (truth);
+    }
+
+    Launcher<ArchMulticore> launcher (8_thread, 4_thread, false, false, 4);
+
+    // Several runs in progress at the same time; the results are the same as the synchronous ones.
+    std::vector<std::future<uint64_t>> futures;
+    for (auto const& v : inputs)  {  futures.push_back (launcher.run_async<VectorChecksum> (split(v)));  }
+
+    for (size_t k=0; k<futures.size(); k++)  {  REQUIRE (futures[k].get() == truths[k]);  }
+
+    // An exception thrown by a task is provided by the future.
+    auto future = launcher.run_async<Exception1> (uint32_t(0));
+    REQUIRE_THROWS (future.get());
+
+    // Same thing for an architecture executing one run at a time; its destruction waits for the pending runs.
+    futures.clear();
+    {
+        Launcher<ArchMulticoreSerial> other (3_thread, 3_thread);
+        for (auto const& v : inputs)  {  futures.push_back (other.run_async<VectorChecksum> (split(v)));  }
+    }
+    for (size_t k=0; k<futures.size(); k++)
+    {
+        REQUIRE (futures[k].wait_for (std::chrono::seconds(0)) == std::future_status::ready);
+        REQUIRE (futures[k].get() == truths[k]);
+    }
+
+    // The first runs may be submitted by several threads at the same time.
+    {
+        Launcher<ArchMulticore> shared (4_thread);
+        std::vector<std::future<uint64_t>> sharedFutures (inputs.size());
+        std::vector<std::thread> threads;
+        for (size_t k=0; k<inputs.size(); k++)
+        {
+            threads.emplace_back ([&,k]  {  sharedFutures[k] = shared.run_async<VectorChecksum> (split(inputs[k]));  });
+        }
+        for (auto& t : threads)  { t.join(); }
+        for (size_t k=0; k<inputs.size(); k++)  {  REQUIRE (sharedFutures[k].get() == truths[k]);  }
+    }
+
+    // A launcher moved while a run is pending: the move waits for the run, which uses the source.
+    {
+        LauncherPoolGate gate;
+
+        auto source = std::make_unique<Launcher<ArchMulticore>> (2_thread);
+        auto pending = source->run_async<LauncherPoolBlock> (gate);
+        gate.wait();
+
+        std::thread opener ([&]
+        {
+            std::this_thread::sleep_for (std::chrono::milliseconds(20));
+            gate.opened = true;
+        });
+
+        Launcher<ArchMulticore> moved (std::move (*source));
+        REQUIRE (pending.wait_for (std::chrono::seconds(0)) == std::future_status::ready);
+        opener.join();
+
+        REQUIRE (pending.get().size() == 2);
+        source.reset();
+
+        // The moved launcher has its own pipeline.
+        REQUIRE (moved.run_async<VectorChecksum> (split(inputs[0])).get() == truths[0]);
+    }
+}
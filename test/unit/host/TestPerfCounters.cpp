@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <common.hpp>
+
+#include <bpl/utils/PerfCounters.hpp>
+
+#include <tasks/VectorChecksum.hpp>
+
+using namespace bpl;
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("PerfCounters multicore", "[PerfCounters]" )
+{
+    bool wasEnabled = PerfCounters::enabled();
+
+    // Not activated -> nothing is measured.
+    PerfCounters::disable();
+    {
+        PerfCounters::Values values;
+        {
+            PerfCounters::Scope scope (values);
+        }
+        REQUIRE (values[PerfCounters::CYCLES] == 0);
+        REQUIRE (PerfCounters::getStatus() == "disabled");
+    }
+
+    PerfCounters::enable();
+
+    std::vector<uint32_t> v (100000, 1);
+
+    Launcher<ArchMulticore> launcher (4_thread);
+    REQUIRE (launcher.run<VectorChecksum> (split(v)) == v.size());
+
+    auto const& stats = launcher.getStatistics();
+
+    // The counters may not be permitted (perf_event_paranoid, virtual machine...): the run must work anyway.
+    if (PerfCounters::available())
+    {
+        REQUIRE (stats.getTag ("perf/status") == "ok");
+        REQUIRE (std::stoull (stats.getTag ("perf/cycles"))       > 0);
+        REQUIRE (std::stoull (stats.getTag ("perf/instructions")) > 0);
+        REQUIRE (std::stod   (stats.getTag ("perf/ipc"))          > 0);
+
+        PerfCounters::Values values;
+        {
+            PerfCounters::Scope scope (values);
+            volatile uint64_t sum = 0;
+            for (uint64_t i=0; i<100000; i++)  {  sum = sum + i;  }
+        }
+        REQUIRE (values[PerfCounters::INSTRUCTIONS] >= 100000);
+    }
+    else
+    {
+        REQUIRE (stats.getTag ("perf/status").starts_with ("unavailable"));
+        REQUIRE (not PerfCounters::active());
+    }
+
+    if (not wasEnabled)  {  PerfCounters::disable();  }
+}
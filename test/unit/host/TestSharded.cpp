@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <common.hpp>
+
+#include <bpl/utils/Sharded.hpp>
+
+#include <thread>
+
+using namespace bpl;
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Sharded threads", "[Sharded]" )
+{
+    REQUIRE (sizeof(Counter<uint32_t>) % CACHE_LINE_SIZE == 0);
+
+    Sharded<uint64_t>  sum;
+    Counter<uint64_t>  counter;
+    Histogram<7>       histo;
+
+    struct Max { uint64_t operator() (uint64_t a, uint64_t b) const { return std::max(a,b); } };
+    Sharded<uint64_t,Max> max;
+
+    // More threads than slots -> some of them share the overflow slot.
+    size_t nbThreads = std::thread::hardware_concurrency() + 16;
+    size_t n = 10000;
+
+    std::vector<std::thread> threads;
+    for (size_t t=0; t<nbThreads; t++)
+    {
+        threads.emplace_back ([&,t]
+        {
+            for (size_t i=0; i<n; i++)
+            {
+                sum.add (i);
+                counter.add();
+                histo.add (i%7);
+                max.add (t*n+i);
+            }
+        });
+    }
+    for (auto& t : threads)  { t.join(); }
+
+    REQUIRE (sum.value()     == nbThreads*n*(n-1)/2);
+    REQUIRE (counter.value() == nbThreads*n);
+    REQUIRE (max.value()     == nbThreads*n-1);
+
+    uint64_t total = 0;
+    for (size_t b=0; b<7; b++)
+    {
+        REQUIRE (histo[b] == nbThreads * ((n+6-b)/7));
+        total += histo[b];
+    }
+    REQUIRE (total == nbThreads*n);
+
+    sum.reset();
+    counter.reset();
+    histo.reset();
+    REQUIRE (sum.value()     == 0);
+    REQUIRE (counter.value() == 0);
+    REQUIRE (histo[3]        == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Sharded index reuse", "[Sharded]" )
+{
+    // The index of an exited thread is given to the next one, so short-lived threads created one
+    // after the other don't end up on the overflow slot.
+    size_t nbSlots = std::max (std::thread::hardware_concurrency(), 1u) + 8;
+
+    for (size_t i=0; i<4*nbSlots; i++)
+    {
+        size_t idx = 0;
+        std::thread ([&] {  idx = impl::getShardIndex();  }).join();
+        REQUIRE (idx < nbSlots);
+    }
+
+    // Threads alive at the same time have different indexes.
+    std::vector<size_t> indexes (8);
+    std::vector<std::thread> threads;
+    std::atomic<size_t> ready = 0;
+    for (size_t i=0; i<indexes.size(); i++)
+    {
+        threads.emplace_back ([&,i]
+        {
+            indexes[i] = impl::getShardIndex();
+            for (ready++; ready < indexes.size(); )  {  std::this_thread::yield();  }
+        });
+    }
+    for (auto& t : threads)  { t.join(); }
+
+    std::sort (indexes.begin(), indexes.end());
+    REQUIRE (std::adjacent_find (indexes.begin(), indexes.end()) == indexes.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+template<class ARCH>
+struct ShardedStats : bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    // Shared by all the process units, updated without lock.
+    static auto& sum()     {  static sharded<uint64_t> value;  return value;  }
+    static auto& histo()   {  static histogram<16>     value;  return value;  }
+    static auto& next()    {  static counter<uint32_t> value;  return value;  }
+
+    auto operator() (uint32_t n)
+    {
+        // Same scheme as Mutex2, with an atomic counter instead of a mutex.
+        uint64_t nb = 0;
+        for (uint32_t i=next().fetch_add(); i<n; i=next().fetch_add(), nb++)
+        {
+            sum().add (i);
+            histo().add (i%16);
+        }
+        return nb;
+    }
+
+    static auto reduce (uint64_t a, uint64_t b)  { return a+b; }
+};
+
+TEST_CASE ("Sharded multicore", "[Sharded]" )
+{
+    using task_t = ShardedStats<ArchMulticore>;
+
+    uint32_t n = 100000;
+
+    Launcher<ArchMulticore> launcher (16_thread);
+    REQUIRE (launcher.run<ShardedStats> (n) == n);
+
+    REQUIRE (task_t::sum().value() == uint64_t(n)*(n-1)/2);
+    for (size_t b=0; b<16; b++)  {  REQUIRE (task_t::histo()[b] == n/16);  }
+}
@@ -7,12 +7,21 @@
 #include <common.hpp>
 
 #include <bpl/utils/split.hpp>
+#include <bpl/utils/Weighted.hpp>
 
 using namespace bpl;
 
 #include <tasks/SketchJaccard.hpp>
 #include <tasks/SketchJaccardOptim.hpp>
 #include <tasks/SketchJaccardTopK.hpp>
+#include <tasks/SketchJaccardTopKHeap.hpp>
+#include <tasks/SketchJaccardDistance.hpp>
+#include <tasks/SketchJaccardIntersect.hpp>
+
+#include <bpl/bank/MinHash.hpp>
+#include <bpl/bank/SketchDistance.hpp>
+#include <filesystem>
+#include <fstream>
 
 //////////////////////////////////////////////////////////////////////////////
 template<typename PROC_UNIT, typename LAUNCHER>
@@ -359,6 +368,136 @@ for (size_t qryCoeff : { 1, 2, 5, 10, 50, 100, 500, 1000, 2000, 5000, 10000})
 }
 }
 
+//////////////////////////////////////////////////////////////////////////////
+template<typename PROC_UNIT, typename ...ARGS>
+void Test_SketchJaccardTopKHeap (PROC_UNIT pu, ARGS... args)
+{
+    using arch_t = typename PROC_UNIT::arch_t;
+    using task_t = SketchJaccardTopKHeap<arch_t>;
+    using hash_t = typename task_t::hash_t;
+    using item_t = typename task_t::item_t;
+
+    Launcher<arch_t> launcher (pu, args...);
+
+    size_t SSIZE  = 64;
+    size_t nbQry  = 20;
+    size_t nbUnits = launcher.getProcUnitNumber();
+
+    // The numbers of reference sketches are not all multiples of the number of units.
+    for (size_t nbRef : {3*nbUnits, 3*nbUnits+1, 2*nbUnits-1, nbUnits/2+1})
+    {
+        // Random steps in a small range, so there are many different counts (and some ties).
+        uint32_t seed = 1;
+        auto generate = [&] (size_t nb)
+        {
+            std::vector<hash_t> v;
+            for (size_t i=0; i<nb; i++)
+            {
+                hash_t x = 0;
+                for (size_t j=0; j<SSIZE; j++)  {  seed = seed*1664525 + 1013904223;  x += 1 + (seed>>28)%4;  v.push_back (x);  }
+            }
+            return v;
+        };
+
+        auto ref = generate (nbRef);
+        auto qry = generate (nbQry);
+
+        // Counts of all the pairs.
+        Launcher<ArchMulticore> multicore {1_thread};
+        auto matrix = SketchDistanceEngine (SSIZE, 1<<18, SimdLevel::SCALAR).compute (multicore, ref, qry);
+
+        // The cost of a reference sketch is put on its last value, so the parts of 'ref' hold whole sketches.
+        // The range of the values of 'ref' is split the same way, which gives to each unit the offset of its part.
+        std::vector<uint64_t> prefix (ref.size()+1);
+        for (size_t i=0; i<prefix.size(); i++)  {  prefix[i] = i/SSIZE;  }
+
+        auto range = std::pair<uint32_t,uint32_t> {0, uint32_t(ref.size())};
+
+        for (uint32_t K : {1, 5, 16, 32})
+        {
+            auto parts = launcher.template run<SketchJaccardTopKHeap> (
+                split(weighted(ref,prefix)), split(weighted(range,prefix)), qry, SSIZE, K
+            );
+
+            for (auto const& part : parts)  {  REQUIRE (part.size() == nbQry*K);  }
+
+            auto result = mergeTopK (parts, K);
+            REQUIRE (result.size() == nbQry*K);
+
+            for (size_t q=0; q<nbQry; q++)
+            {
+                std::vector<item_t> truth;
+                for (size_t r=0; r<nbRef; r++)  {  truth.push_back (item_t { uint32_t(r), matrix[r*nbQry+q] });  }
+                std::sort (truth.begin(), truth.end(), item_t::better);
+                truth.resize (K, item_t{});
+
+                for (size_t i=0; i<K; i++)  {  REQUIRE (result[q*K+i] == truth[i]);  }
+            }
+        }
+
+        // K greater than KMAX is rejected.
+        REQUIRE_THROWS (launcher.template run<SketchJaccardTopKHeap> (
+            split(weighted(ref,prefix)), split(weighted(range,prefix)), qry, SSIZE, task_t::KMAX+1
+        ));
+
+        // A split of 'ref' that cuts a sketch is rejected instead of giving wrong identifiers.
+        if (nbRef % nbUnits != 0)
+        {
+            REQUIRE_THROWS (launcher.template run<SketchJaccardTopKHeap> (split(ref), split(range), qry, SSIZE, 1));
+        }
+    }
+}
+
+TEST_CASE ("SketchJaccardTopKHeap", "[Sketch]" )
+{
+    Test_SketchJaccardTopKHeap (ArchUpmem    ::DPU    {4});
+    Test_SketchJaccardTopKHeap (ArchMulticore::Thread {7});
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("TopK", "[Sketch]" )
+{
+    using item_t = TopKItem<uint32_t,uint16_t>;
+
+    uint32_t seed = 1;
+
+    for (size_t n : {0,1,2,5,10,100,1000})
+    {
+        for (size_t k : {0,1,3,8,16,100})
+        {
+            TopK<item_t,16> topk (k);
+            REQUIRE (topk.capacity() == std::min (k, size_t(16)));
+
+            std::vector<item_t> items;
+            for (size_t i=0; i<n; i++)
+            {
+                seed = seed*1664525 + 1013904223;
+                items.push_back (item_t { uint32_t(i), uint16_t((seed>>16)%50) });
+                topk.insert (items.back());
+            }
+
+            std::vector<item_t> result;
+            topk.flush (result);
+            REQUIRE (result.size() == topk.capacity());
+            REQUIRE (topk.size() == 0);
+
+            std::sort (items.begin(), items.end(), item_t::better);
+            for (size_t i=0; i<result.size(); i++)
+            {
+                if (i<items.size())  {  REQUIRE (result[i] == items[i]);  }
+                else                 {  REQUIRE (result[i].empty());      }
+            }
+        }
+    }
+
+    // The parts must hold K items per query.
+    std::vector<std::vector<item_t>> parts (2, std::vector<item_t> (32));
+    REQUIRE_NOTHROW (mergeTopK (parts,  8));
+    REQUIRE_THROWS  (mergeTopK (parts, 33));
+    parts[1].resize (16);
+    REQUIRE_THROWS  (mergeTopK (parts,  8));
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 TEST_CASE ("SketchJaccard2", "[Sketch]" )
@@ -391,3 +530,301 @@ TEST_CASE ("SketchJaccard2", "[Sketch]" )
 
     //launcher.getStatistics().dump(true);
 }
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("CanonicalKmers", "[Sketch]" )
+{
+    std::string seq = "ACGTTGCAANGGCATTACGGATCCGATTAGCAGGATTACAGATTACCAGGTACCA";
+
+    std::string rc (seq.rbegin(), seq.rend());
+    for (auto& c : rc)  {  c = c=='A' ? 'T' : c=='T' ? 'A' : c=='C' ? 'G' : c=='G' ? 'C' : c;  }
+
+    for (size_t k : {1,5,11,21,31,32})
+    {
+        std::vector<uint64_t> v1;  iterateCanonicalKmers (seq, k, [&] (uint64_t x) { v1.push_back(x); });
+        std::vector<uint64_t> v2;  iterateCanonicalKmers (rc,  k, [&] (uint64_t x) { v2.push_back(x); });
+
+        // The k-mers holding the 'N' are skipped.
+        size_t nbKmers = 0;
+        for (size_t i=0; i+k<=seq.size(); i++)  {  nbKmers += seq.substr(i,k).find('N')==std::string::npos ? 1 : 0;  }
+        REQUIRE (v1.size() == nbKmers);
+
+        // A sequence and its reverse complement have the same canonical k-mers (in reverse order).
+        std::reverse (v2.begin(), v2.end());
+        REQUIRE (v1 == v2);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("MinHashBuilder", "[Sketch]" )
+{
+    size_t k = 21;
+    size_t s = 100;
+
+    // We generate random sequences, each one being a mutated copy of the previous one.
+    std::string filename = std::filesystem::temp_directory_path() / fmt::format ("bpl_test_minhash_{}.fa", getpid());
+    std::vector<std::string> sequences;
+    {
+        std::ofstream file (filename);
+        uint32_t seed = 1;
+        auto rnd = [&] () { return seed = seed*1664525 + 1013904223; };
+
+        std::string seq;
+        for (size_t i=0; i<5000; i++)  { seq += "ACGT"[(rnd()>>16)%4]; }
+
+        for (size_t n=0; n<200; n++)
+        {
+            for (size_t i=0; i<10; i++)  { seq[(rnd()>>8)%seq.size()] = "ACGT"[(rnd()>>16)%4]; }
+
+            // Some sequences have less than s k-mers
+            std::string current = n%10==0 ? seq.substr(0,50) : seq;
+
+            sequences.push_back (current);
+            file << ">seq" << n << "\n" << current << "\n";
+        }
+    }
+
+    MinHashBuilder builder (k, s);
+
+    // The truth is computed sequence by sequence.
+    std::vector<uint32_t> truth;
+    std::vector<uint32_t> truthLengths;
+    for (auto const& seq : sequences)
+    {
+        size_t length = 0;
+        auto sketch = builder.build (seq, length);
+        REQUIRE (sketch.size() == s);
+        REQUIRE (std::is_sorted (sketch.begin(), sketch.end()));
+
+        // Distinct real values, completed with padding values.
+        REQUIRE (std::adjacent_find (sketch.begin(), sketch.begin()+length) == sketch.begin()+length);
+        REQUIRE (std::all_of (sketch.begin()+length, sketch.end(), [] (auto x)  {  return x==MinHashSketch<uint32_t>::PADDING;  }));
+        REQUIRE ((length==s) == (seq.size()>=k+s));
+        REQUIRE (builder.build (seq) == sketch);
+        truth.insert (truth.end(), sketch.begin(), sketch.end());
+        truthLengths.push_back (length);
+    }
+
+    BankFasta bank (filename);
+
+    for (size_t nbThreads : {1,2,3,8})
+    {
+        Launcher<ArchMulticore> launcher {ArchMulticore::Thread{nbThreads}};
+
+        std::vector<uint32_t> lengths;
+        auto sketches = builder.build (launcher, bank, lengths);
+
+        REQUIRE (sketches == truth);
+        REQUIRE (lengths  == truthLengths);
+        REQUIRE (builder.build (launcher, bank) == truth);
+
+        // The sketches can be directly used by SketchJaccardDistance: a sketch shares all its values with itself
+        // and consecutive sequences (almost identical) share most of their values.
+        auto distances = launcher.run<SketchJaccardDistance> (sketches, sketches, s);
+        size_t nb = sequences.size();
+        for (auto const& d : distances)
+        {
+            REQUIRE (d.size() == nb*nb);
+            REQUIRE (d[nb+2] >  s/2);
+            REQUIRE (d[nb+1] == s);
+        }
+
+        // With the lengths, the padding values of the short sequences (every 10th one) are not counted as common values.
+        std::vector<uint16_t> d (nb*nb);
+        SketchDistanceEngine (s).compute (launcher, sketches, lengths, sketches, lengths, d);
+
+        for (size_t i=0; i<nb; i+=5)
+        {
+            const uint32_t* si = sketches.data() + i*s;
+            size_t li = lengths[i];
+            REQUIRE ((li < s) == (i%10==0));
+            REQUIRE (d[i*nb+i] == li);
+
+            for (size_t j=0; j<nb; j+=5)
+            {
+                const uint32_t* sj = sketches.data() + j*s;
+                size_t lj = lengths[j];
+
+                std::vector<uint32_t> common;
+                std::set_intersection (si, si+li, sj, sj+lj, std::back_inserter(common));
+                REQUIRE (d[i*nb+j] == common.size());
+            }
+        }
+    }
+
+    std::filesystem::remove (filename);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("IntersectCount", "[Sketch]" )
+{
+    uint32_t seed = 1;
+    auto rnd = [&] () { return seed = seed*1664525 + 1013904223; };
+
+    // Strictly increasing random values, the density controlling the number of common items.
+    auto generate = [&] (size_t n, uint32_t step)
+    {
+        std::vector<uint32_t> v;
+        uint32_t x = rnd() % step;
+        for (size_t i=0; i<n; i++)  {  x += 1 + rnd()%step;  v.push_back (x);  }
+        return v;
+    };
+
+    for (size_t na : {0,1,3,4,7,8,15,16,17,31,33,100,1000})
+    {
+        for (size_t nb : {0,1,5,8,16,20,64,999})
+        {
+            for (uint32_t step : {1,2,4,100})
+            {
+                auto a = generate (na, step);
+                auto b = generate (nb, step);
+
+                std::vector<uint32_t> common;
+                std::set_intersection (a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(common));
+
+                for (int level=0; level<=int(getSimdLevel()); level++)
+                {
+                    auto kernel = getIntersectKernel (SimdLevel(level));
+                    REQUIRE (kernel (a.data(), a.size(), b.data(), b.size()) == common.size());
+                    REQUIRE (kernel (b.data(), b.size(), a.data(), a.size()) == common.size());
+                }
+
+                REQUIRE (intersect_count (a.data(), a.size(), b.data(), b.size()) == common.size());
+            }
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("SketchJaccardIntersect", "[Sketch]" )
+{
+    using hash_t = SketchJaccardIntersect<ArchMulticore>::hash_t;
+
+    size_t SSIZE = 1000;
+
+    std::vector<hash_t> ref;
+    std::vector<hash_t> qry;
+
+    for (size_t i=1; i<=64; i++)  {  for (size_t j=0; j<SSIZE; j++)  {  ref.push_back (i*j);   }  }
+    for (size_t i=1; i<=10; i++)  {  for (size_t j=0; j<SSIZE; j++)  {  qry.push_back (i*j+i);  }  }
+
+    Launcher<ArchMulticore> launcher {ArchMulticore::Thread{4}};
+
+    auto truth  = launcher.run<SketchJaccardDistance>  (split(ref), qry, SSIZE);
+    auto result = launcher.run<SketchJaccardIntersect> (split(ref), qry, SSIZE);
+
+    REQUIRE (truth.size() == result.size());
+    for (size_t i=0; i<truth.size(); i++)  {  REQUIRE (truth[i] == result[i]);  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("SketchDistanceEngine", "[Sketch]" )
+{
+    using hash_t  = SketchDistanceEngine::hash_t;
+    using count_t = SketchDistanceEngine::count_t;
+
+    // Without padding, the query sketches are compared with the reference ones with SketchJaccardDistance,
+    // whose result is the transpose of the matrix computed by the engine. With padding, only the real values
+    // of the sketches (given by their lengths) are compared.
+    auto check = [] (size_t nbRef, size_t nbQry, size_t ssize, size_t cacheSize, size_t nbThreads, bool padding)
+    {
+        std::vector<hash_t> ref;
+        std::vector<hash_t> qry;
+
+        for (size_t i=0; i<nbRef; i++)  {  for (size_t j=0; j<ssize; j++)  {  ref.push_back (j*(1+i%3) + i%5);  }  }
+        for (size_t i=0; i<nbQry; i++)  {  for (size_t j=0; j<ssize; j++)  {  qry.push_back (j*(1+i%4) + i%2);  }  }
+
+        std::vector<uint32_t> refLengths (nbRef, ssize);
+        std::vector<uint32_t> qryLengths (nbQry, ssize);
+
+        // Some sketches are completed with padding values from various positions; the padding value is also
+        // a legal hash value, here the last one of some complete sketches.
+        if (padding)
+        {
+            for (size_t i=0; i<nbRef; i++)  {  if (i%4==0)  { ref[i*ssize+ssize-1] = MinHashSketch<hash_t>::PADDING;  continue; }  refLengths[i] = ssize/2 + i%7;  }
+            for (size_t i=0; i<nbQry; i++)  {  if (i%3==1)  { qry[i*ssize+ssize-1] = MinHashSketch<hash_t>::PADDING;  continue; }  qryLengths[i] = ssize/3 + i%5;  }
+
+            for (size_t i=0; i<nbRef; i++)  {  for (size_t j=refLengths[i]; j<ssize; j++)  {  ref[i*ssize+j] = MinHashSketch<hash_t>::PADDING;  }  }
+            for (size_t i=0; i<nbQry; i++)  {  for (size_t j=qryLengths[i]; j<ssize; j++)  {  qry[i*ssize+j] = MinHashSketch<hash_t>::PADDING;  }  }
+        }
+
+        Launcher<ArchMulticore> launcher {ArchMulticore::Thread{nbThreads}};
+
+        std::vector<count_t> truth;
+        if (not padding)
+        {
+            for (auto const& part : Launcher<ArchMulticore>{1_thread}.run<SketchJaccardDistance> (ref, qry, ssize))
+            {
+                truth.insert (truth.end(), part.begin(), part.end());
+            }
+        }
+        else
+        {
+            for (size_t q=0; q<nbQry; q++)
+            {
+                for (size_t r=0; r<nbRef; r++)
+                {
+                    std::vector<hash_t> common;
+                    std::set_intersection (ref.begin()+r*ssize, ref.begin()+r*ssize+refLengths[r],
+                                           qry.begin()+q*ssize, qry.begin()+q*ssize+qryLengths[q], std::back_inserter(common));
+                    truth.push_back (common.size());
+                }
+            }
+        }
+
+        // The default instruction set (the engine default) and each lower one give the scalar counts.
+        for (int level=int(getSimdLevel()); level>=0; level--)
+        {
+            SketchDistanceEngine engine (ssize, cacheSize, SimdLevel(level));
+
+            std::vector<count_t> matrix (nbRef*nbQry, 0xFFFF);
+            REQUIRE (engine.compute (launcher, ref, refLengths, qry, qryLengths, matrix) == nbRef*nbQry);
+
+            for (size_t r=0; r<nbRef; r++)
+            {
+                for (size_t q=0; q<nbQry; q++)  {  REQUIRE (matrix[r*nbQry+q] == truth[q*nbRef+r]);  }
+            }
+        }
+
+        SketchDistanceEngine engine (ssize, cacheSize);
+
+        std::vector<count_t> matrix (nbRef*nbQry, 0xFFFF);
+        engine.compute (launcher, ref, refLengths, qry, qryLengths, matrix);
+
+        if (not padding)  {  REQUIRE (engine.compute (launcher, ref, qry) == matrix);  }
+
+        // Each chunk of a dynamic scheduling writes the tiles of its own part of the matrix.
+        Launcher<ArchMulticore> dynamic (ArchMulticore::Thread{nbThreads}, ArchMulticore::Thread{nbThreads}, false, false, 3);
+
+        std::vector<count_t> matrix2 (nbRef*nbQry, 0xFFFF);
+        REQUIRE (engine.compute (dynamic, ref, refLengths, qry, qryLengths, matrix2) == nbRef*nbQry);
+        REQUIRE (matrix2 == matrix);
+    };
+
+    for (size_t nbThreads : {1,3,8})
+    {
+        for (size_t cacheSize : {0, 1000, 10000, 1<<18})
+        {
+            check (37, 23, 50, cacheSize, nbThreads, false);
+            check (37, 23, 50, cacheSize, nbThreads, true);
+            check (20, 30,200, cacheSize, nbThreads, true);
+            check ( 1, 40, 16, cacheSize, nbThreads, false);
+            check (40,  1, 16, cacheSize, nbThreads, false);
+        }
+    }
+
+    // Output matrix too small.
+    Launcher<ArchMulticore> launcher {ArchMulticore::Thread{2}};
+    std::vector<hash_t>  sketches (4*10);
+    std::vector<count_t> matrix   (15);
+    REQUIRE_THROWS (SketchDistanceEngine(10).compute (launcher, sketches, sketches, matrix));
+
+    // One length per sketch, not greater than the sketch size.
+    std::vector<uint32_t> lengths (4, 10);
+    std::vector<count_t>  matrix2 (16);
+    REQUIRE_NOTHROW (SketchDistanceEngine(10).compute (launcher, sketches, lengths, sketches, lengths, matrix2));
+    lengths.push_back (10);
+    REQUIRE_THROWS  (SketchDistanceEngine(10).compute (launcher, sketches, lengths, sketches, {}, matrix2));
+    lengths = {10, 11, 10, 10};
+    REQUIRE_THROWS  (SketchDistanceEngine(10).compute (launcher, sketches, {}, sketches, lengths, matrix2));
+}
@@ -8,6 +8,7 @@
 
 #include <bpl/utils/split.hpp>
 #include <bpl/utils/Range.hpp>
+#include <bpl/utils/Weighted.hpp>
 
 #include <tasks/RangeSplit.hpp>
 #include <tasks/Checksum3.hpp>
@@ -18,6 +19,7 @@
 #include <tasks/SplitDifferentSizes.hpp>
 #include <tasks/VectorSplitDpu.hpp>
 #include <tasks/VectorSplitSimple.hpp>
+#include <tasks/VectorSplitStrided.hpp>
 #include <tasks/VectorSplitOverload.hpp>
 #include <tasks/SplitMyLong.hpp>
 
@@ -279,6 +281,268 @@ TEST_CASE ("is_splitable", "[Split]" )
 
 }
 
+//////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("is_splitable_kind", "[Split]" )
+{
+    static_assert (is_splitable_kind_v<std::vector<int>,   SplitKind::RAKE>  == true);
+    static_assert (is_splitable_kind_v<std::vector<int>,   SplitKind::RAND>  == true);
+    static_assert (is_splitable_kind_v<std::span<int>,     SplitKind::RAKE>  == true);
+    static_assert (is_splitable_kind_v<std::span<int>,     SplitKind::RAND>  == true);
+    static_assert (is_splitable_kind_v<bpl::Range,         SplitKind::RAKE>  == true);
+    static_assert (is_splitable_kind_v<bpl::Range,         SplitKind::RAND>  == false);
+    static_assert (is_splitable_kind_v<std::pair<int,int>, SplitKind::CONT>  == true);
+    static_assert (is_splitable_kind_v<std::pair<int,int>, SplitKind::RAKE>  == false);
+    static_assert (is_splitable_kind_v<int,                SplitKind::CONT>  == false);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("SplitPermutation", "[Split]" )
+{
+    for (size_t n=1; n<=2000; n++)
+    {
+        impl::SplitPermutation perm (n);
+
+        std::vector<bool> found (n,false);
+        for (size_t p=0; p<n; p++)
+        {
+            size_t i = perm(p);
+            REQUIRE (i < n);
+            REQUIRE (found[i] == false);
+            REQUIRE (perm.inverse(i) == p);
+            found[i] = true;
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+template<SplitKind KIND>
+void SplitKind_aux (size_t nbItems, size_t total)
+{
+    std::vector<uint32_t> v0;  for (size_t i=0; i<nbItems; i++)  { v0.push_back(i); }
+
+    std::vector<size_t> found (nbItems,0);
+
+    size_t minSize = ~size_t(0);
+    size_t maxSize = 0;
+
+    for (size_t idx=0; idx<total; idx++)
+    {
+        auto part1 = split_kind<KIND> (v0, idx, total);
+        auto part2 = split_kind<KIND> (std::span<uint32_t>(v0), idx, total);
+
+        REQUIRE (std::equal (part1.begin(), part1.end(), part2.begin(), part2.end()));
+
+        for (size_t i=0; i<part1.size(); i++)
+        {
+            found[part1[i]]++;
+            if (KIND==SplitKind::RAKE)  { REQUIRE (part1[i] == idx + i*total); }
+
+            // The RAKE and RAND parts are views on the vector, not copies.
+            if (KIND!=SplitKind::CONT)  { REQUIRE (&part1[i] == &v0[part1[i]]); }
+        }
+
+        minSize = std::min (minSize, part1.size());
+        maxSize = std::max (maxSize, part1.size());
+
+        if constexpr (KIND==SplitKind::RAKE)
+        {
+            // A range is split the same way as a vector holding the same items.
+            auto range = split_kind<KIND> (Range(0,nbItems), idx, total);
+            REQUIRE (range.size() == part1.size());
+            size_t i=0;  for (auto x : range)  {  REQUIRE (x == part1[i++]);  }
+        }
+    }
+
+    // Each item is found exactly once and the parts are balanced.
+    for (auto n : found)  { REQUIRE (n==1); }
+    REQUIRE (maxSize-minSize <= 1);
+}
+
+TEST_CASE ("SplitKind", "[Split]" )
+{
+    for (size_t nbItems=0; nbItems<=300; nbItems++)
+    {
+        for (size_t total : {1,2,3,5,8,13,21,64})
+        {
+            SplitKind_aux<SplitKind::CONT> (nbItems, total);
+            SplitKind_aux<SplitKind::RAKE> (nbItems, total);
+            SplitKind_aux<SplitKind::RAND> (nbItems, total);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("SplitPermutationSeed", "[Split]" )
+{
+    for (size_t n : {1,2,3,100,1000,12345})
+    {
+        std::vector<uint32_t> v;  for (size_t i=0; i<n; i++)  { v.push_back(i); }
+
+        auto parts = [&] (uint32_t seed)
+        {
+            std::vector<std::vector<uint32_t>> result;
+            for (size_t idx=0; idx<8; idx++)  {  result.push_back (split_kind<SplitKind::RAND> (v, idx, 8, seed).to_vector());  }
+            return result;
+        };
+
+        for (uint32_t seed : {0,1,2,42})
+        {
+            // Each seed gives a bijection and the same seed gives the same parts.
+            impl::SplitPermutation perm (n, seed);
+            std::vector<bool> found (n,false);
+            for (size_t p=0; p<n; p++)
+            {
+                REQUIRE (found[perm(p)] == false);
+                REQUIRE (perm.inverse(perm(p)) == p);
+                found[perm(p)] = true;
+            }
+
+            REQUIRE (parts(seed) == parts(seed));
+        }
+
+        if (n>=100)  {  REQUIRE (parts(1) != parts(2));  }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+template<SplitKind KIND, typename RESOURCE>
+void SplitKindRun_aux (size_t nbItems, RESOURCE resource)
+{
+    using arch_t  = typename RESOURCE::arch_t;
+    using level_t = typename arch_t::lowest_level_t;
+
+    std::vector<uint32_t> v;  for (size_t i=1; i<=nbItems; i++)  { v.push_back(i); }
+
+    Launcher<arch_t> launcher {resource};
+
+    REQUIRE (launcher.template run<VectorSplitSimple> (split<level_t,KIND>(v)) == nbItems*(nbItems+1)/2);
+    REQUIRE (launcher.template run<VectorSplitSimple> (split<level_t,KIND>(v,1234)) == nbItems*(nbItems+1)/2);
+
+    if constexpr (is_splitable_kind_v<Range,KIND>)
+    {
+        REQUIRE (launcher.template run<SplitRangeInt> (split<level_t,KIND>(Range(0,nbItems))) == nbItems*(nbItems-1)/2);
+    }
+}
+
+TEST_CASE ("SplitKindMulticore", "[Split]" )
+{
+    for (size_t nbItems : {0,1,10,1000,12345})
+    {
+        for (size_t nbResource : {1,2,3,5,8,13})
+        {
+            SplitKindRun_aux<SplitKind::RAKE> (nbItems, ArchMulticore::Thread{nbResource});
+            SplitKindRun_aux<SplitKind::RAND> (nbItems, ArchMulticore::Thread{nbResource});
+        }
+    }
+
+    // A task taking a strided view gets the parts without copy.
+    std::vector<uint32_t> v;  for (size_t i=1; i<=10000; i++)  { v.push_back(i); }
+    Launcher<ArchMulticore> launcher {7_thread};
+    REQUIRE (launcher.run<VectorSplitStrided> (split<SplitKind::RAKE>(v))     == v.size()*(v.size()+1)/2);
+    REQUIRE (launcher.run<VectorSplitStrided> (split<SplitKind::RAND>(v,99))  == v.size()*(v.size()+1)/2);
+}
+
+TEST_CASE ("SplitKindUpmem", "[Split]" )
+{
+    for (size_t nbItems : {1,1000,12345})
+    {
+        SplitKindRun_aux<SplitKind::RAKE> (nbItems, ArchUpmem::Rank{1});
+        SplitKindRun_aux<SplitKind::RAND> (nbItems, ArchUpmem::Rank{1});
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void SplitWeighted_aux (size_t nbItems, size_t total)
+{
+    // The cost of an item is its value, the first items being the most expensive ones.
+    std::vector<uint32_t> v;  for (size_t i=0; i<nbItems; i++)  { v.push_back (1 + (nbItems-i)*(nbItems-i)); }
+
+    auto w = weighted (v, [] (uint32_t x) { return x; });
+
+    uint64_t maxItem = nbItems>0 ? v[0] : 0;
+    uint64_t mean    = w.cost() / total;
+
+    size_t next = 0;
+    for (size_t idx=0; idx<total; idx++)
+    {
+        auto [i0,i1] = w.bounds (idx, total);
+
+        // The parts are contiguous and cover all the items.
+        REQUIRE (i0 == next);
+        next = i1;
+
+        // The cost of a part is close to the mean cost (up to one item on each side).
+        uint64_t cost = w.cost (i0, i1);
+        REQUIRE (cost <= mean + 2*maxItem);
+        REQUIRE (cost + 2*maxItem >= mean);
+
+        auto part = SplitOperator<decltype(w)>::split (w, idx, total);
+        REQUIRE (part.size() == i1-i0);
+        REQUIRE (std::equal (part.begin(), part.end(), v.begin()+i0));
+
+        // Same intervals with a range, a pair and the prefix sums.
+        auto range = SplitOperator<Weighted<Range>>::split (weighted (Range(0,nbItems), [&] (auto i) { return v[i]; }), idx, total);
+        REQUIRE (range.first() == i0);
+        REQUIRE (range.last()  == i1);
+
+        auto pair = SplitOperator<Weighted<std::pair<size_t,size_t>>>::split (weighted (std::pair<size_t,size_t>(0,nbItems), [&] (auto i) { return v[i]; }), idx, total);
+        REQUIRE (pair == std::make_pair (i0,i1));
+
+        std::vector<uint64_t> prefix {0};  for (auto x : v)  { prefix.push_back (prefix.back() + x); }
+        REQUIRE (weighted (v, prefix).bounds (idx,total) == std::make_pair (i0,i1));
+
+        // A temporary object is owned by the Weighted object, so it can be split later on.
+        auto owned = weighted (std::vector<uint32_t>(v), [] (uint32_t x) { return x; });
+        auto copy  = owned;
+        auto part2 = SplitOperator<decltype(copy)>::split (copy, idx, total);
+        REQUIRE (std::equal (part2.begin(), part2.end(), part.begin(), part.end()));
+
+        auto ranged = weighted (Range(0,nbItems), prefix);
+        REQUIRE (SplitOperator<decltype(ranged)>::split (ranged, idx, total).first() == i0);
+    }
+    REQUIRE (next == nbItems);
+}
+
+TEST_CASE ("SplitWeighted", "[Split]" )
+{
+    for (size_t nbItems=0; nbItems<=200; nbItems++)
+    {
+        for (size_t total : {1,2,3,5,8,13,21,64})
+        {
+            SplitWeighted_aux (nbItems, total);
+        }
+    }
+}
+
+TEST_CASE ("SplitWeightedMulticore", "[Split]" )
+{
+    std::vector<uint32_t> v;  for (size_t i=1; i<=10000; i++)  { v.push_back (i); }
+
+    for (size_t nbResource : {1,2,3,5,8,13})
+    {
+        Launcher<ArchMulticore> launcher {ArchMulticore::Thread{nbResource}};
+
+        auto w = weighted (v, [] (uint32_t x) { return x; });
+
+        REQUIRE (launcher.run<VectorSplitSimple> (split(w)) == v.size()*(v.size()+1)/2);
+    }
+}
+
+TEST_CASE ("SplitWeightedUpmem", "[Split]" )
+{
+    // The first items are the most expensive ones.
+    std::vector<uint32_t> v;  for (size_t i=1; i<=10000; i++)  { v.push_back (10001-i); }
+
+    auto w = weighted (v, [] (uint32_t x) { return x; });
+
+    for (size_t nbResource : {1,2,5,8})
+    {
+        Launcher<ArchUpmem> launcher {ArchUpmem::DPU{nbResource}};
+
+        REQUIRE (launcher.run<VectorSplitSimple> (split(w)) == v.size()*(v.size()+1)/2);
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 template<class ARCH>
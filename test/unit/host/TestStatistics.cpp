@@ -0,0 +1,212 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <common.hpp>
+
+#include <bpl/utils/Statistics.hpp>
+
+#include <tasks/GetPuid.hpp>
+
+#include <thread>
+
+using namespace bpl;
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("LatencyHistogram", "[Statistics]" )
+{
+    LatencyHistogram h;
+    REQUIRE (h.getCount()          == 0);
+    REQUIRE (h.getPercentile(0.5)  == 0);
+
+    // Values 1..10000 ns
+    for (uint64_t v=1; v<=10000; v++)  {  h.record (v);  }
+
+    REQUIRE (h.getCount() == 10000);
+    REQUIRE (h.getMin()   == 1);
+    REQUIRE (h.getMax()   == 10000);
+    REQUIRE (h.getMean()  == Approx(5000.5));
+
+    // The relative error is less than 1/16.
+    for (double q : {0.01, 0.1, 0.5, 0.9, 0.99})
+    {
+        double exact = q*10000;
+        REQUIRE (std::abs (double(h.getPercentile(q)) - exact) <= exact/LatencyHistogram::SUB + 1);
+    }
+    REQUIRE (h.getPercentile(1.0) == 10000);
+
+    // Small values are exact.
+    LatencyHistogram small;
+    for (uint64_t v : {3, 3, 3, 7})  {  small.record (v);  }
+    REQUIRE (small.getPercentile(0.5)  == 3);
+    REQUIRE (small.getPercentile(0.99) == 7);
+
+    h.merge (small);
+    REQUIRE (h.getCount() == 10004);
+    REQUIRE (h.getMin()   == 1);
+
+    // Large values don't overflow the buckets.
+    LatencyHistogram large;
+    large.record (std::numeric_limits<uint64_t>::max());
+    REQUIRE (large.getPercentile(0.5) == std::numeric_limits<uint64_t>::max());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Statistics phases", "[Statistics]" )
+{
+    Statistics stats;
+
+    for (size_t i=0; i<10; i++)
+    {
+        auto ts = stats.timer<"test","sleep">();
+        std::this_thread::sleep_for (std::chrono::microseconds(100));
+    }
+
+    // Same phase through the runtime names.
+    {
+        auto ts = stats.produceCumulTimestamp ("test", "sleep");
+        ts.stop();
+        ts.start();
+        ts.stop();
+    }
+
+    // Same phase interned once, outside the loop.
+    Statistics::Phase sleep ("test", "sleep");
+    for (size_t i=0; i<3; i++)  {  auto ts = stats.produceCumulTimestamp (sleep);  }
+
+    auto h = stats.getHistogram ("test", "sleep");
+    REQUIRE (h.getCount() == 15);
+    REQUIRE (h.getPercentile(0.99) >= 100*1000);
+
+    REQUIRE (stats.getTiming ("test/cumul/sleep") >= 10 * 100e-6);
+    REQUIRE (stats.getTiming ("test/once/sleep")  <  stats.getTiming ("test/cumul/sleep"));
+    REQUIRE (stats.getTimings().contains ("test/once/sleep"));
+
+    // Measures made elsewhere.
+    Statistics::Phase phase ("test", "external");
+    stats.record (phase, 1000);
+    stats.record (phase, 3000);
+    REQUIRE (stats.getHistogram ("test", "external").getMax() == 3000);
+    REQUIRE (stats.getTiming ("test/cumul/external") == Approx(4000e-9));
+
+    // The statistics of a phase not measured are empty, and reading them doesn't intern the phase.
+    size_t id0 = Statistics::Phase ("test", "before").id();
+    REQUIRE (stats.getHistogram ("test", "nothing").getCount() == 0);
+    REQUIRE (stats.getTiming ("test/cumul/nothing") == 0);
+    REQUIRE (Statistics::Phase ("test", "after").id() == id0+1);
+
+    // A copy holds the same measures.
+    Statistics copy = stats;
+    REQUIRE (copy.getHistogram ("test", "sleep")   .getCount() == 15);
+    REQUIRE (copy.getHistogram ("test", "external").getCount() == 2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Statistics concurrent records", "[Statistics]" )
+{
+    Statistics stats;
+    Statistics::Phase phase ("test", "concurrent");
+
+    size_t nbThreads = 8;
+    size_t n = 10000;
+
+    std::vector<std::thread> threads;
+    for (size_t t=0; t<nbThreads; t++)
+    {
+        threads.emplace_back ([&,t]  {  for (size_t i=0; i<n; i++)  {  stats.record (phase, 1000*(t+1));  }  });
+    }
+    for (auto& t : threads)  { t.join(); }
+
+    auto h = stats.getHistogram ("test", "concurrent");
+    REQUIRE (h.getCount() == nbThreads*n);
+    REQUIRE (h.getMin()   == 1000);
+    REQUIRE (h.getMax()   == 1000*nbThreads);
+    REQUIRE (stats.getTiming ("test/cumul/concurrent") == Approx (n * 1000e-9 * nbThreads*(nbThreads+1)/2));
+
+    // A single timing is read without merging all the measures, with the same value.
+    REQUIRE (stats.getTimings().at ("test/cumul/concurrent") == stats.getTiming ("test/cumul/concurrent"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Statistics multicore jobs", "[Statistics]" )
+{
+    Launcher<ArchMulticore> launcher (8_thread);
+
+    for (size_t i=0; i<5; i++)  {  launcher.run<GetPuid> ();  }
+
+    // One measure per job and per run.
+    auto h = launcher.getStatistics().getHistogram ("run", "job");
+    REQUIRE (h.getCount() == 5*8);
+    REQUIRE (h.getMax()   >= h.getPercentile(0.5));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+template<class ARCH>
+struct StatisticsImbalance : bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    // The first process unit is much slower than the other ones.
+    auto operator() (vector_view<uint32_t> const& v)
+    {
+        std::this_thread::sleep_for (std::chrono::milliseconds (this->tuid()==0 ? 40 : 2));
+        uint64_t result = 0;
+        for (auto x : v)  {  result += x;  }
+        return result;
+    }
+
+    static auto reduce (uint64_t a, uint64_t b)  { return a+b; }
+};
+
+TEST_CASE ("Statistics multicore imbalance", "[Statistics]" )
+{
+    std::vector<uint32_t> v (1000);
+    for (size_t i=0; i<v.size(); i++)  {  v[i] = i;  }
+
+    Launcher<ArchMulticore> launcher (4_thread);
+    REQUIRE (launcher.run<StatisticsImbalance> (split(v)) == v.size()*(v.size()-1)/2);
+
+    auto const& stats = launcher.getStatistics();
+
+    // Same distribution as the tasklets of ArchUpmem.
+    REQUIRE (stats.getTag ("multicore/time/max").starts_with ("time: 0.04"));
+    REQUIRE (stats.getTag ("multicore/time/min").starts_with ("time: 0.00"));
+    REQUIRE (stats.getTag ("multicore/time/quantiles").starts_with ("[ 4]"));
+
+    REQUIRE (std::stod (stats.getTag ("multicore/imbalance")) > 2.0);
+    REQUIRE (not stats.getTimings().contains ("multicore/imbalance"));
+    REQUIRE (stats.getTiming ("multicore/time/exec")  >= 0.045);
+    REQUIRE (stats.getTiming ("multicore/time/split") >  0);
+    REQUIRE (stats.getTiming ("multicore/time/wall")  >= 0.040);
+
+    // Each worker of the run (and the caller) was busy at most during the run; the other workers of the
+    // executor are not reported.
+    auto checkIdle = [] (auto const& stats)
+    {
+        size_t nbWorkers = 0;
+        for (auto const& [key,value] : stats.getTimings())
+        {
+            if (key.starts_with ("multicore/idle/"))
+            {
+                nbWorkers++;
+                REQUIRE (value >= 0);
+                REQUIRE (value <= stats.getTiming ("multicore/time/wall"));
+            }
+        }
+        REQUIRE (nbWorkers >= 2);
+        REQUIRE (nbWorkers <= std::min (Executor::instance().size(), std::size_t(4)) + 1);
+        REQUIRE (stats.getTimings().contains ("multicore/idle/caller"));
+
+        // At most 4 slots of the lease were idle during the whole run.
+        REQUIRE (stats.getTiming ("multicore/time/idle") >= 0);
+        REQUIRE (stats.getTiming ("multicore/time/idle") <= 4*stats.getTiming ("multicore/time/wall") + 1e-6);
+    };
+
+    checkIdle (stats);
+
+    // The keys of the previous run are replaced.
+    REQUIRE (launcher.run<StatisticsImbalance> (split(v)) == v.size()*(v.size()-1)/2);
+    checkIdle (launcher.getStatistics());
+}
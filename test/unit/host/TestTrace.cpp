@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#include <common.hpp>
+
+#include <bpl/utils/Trace.hpp>
+
+#include <tasks/VectorChecksum.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <thread>
+#include <algorithm>
+
+using namespace bpl;
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Trace multicore", "[Trace]" )
+{
+    std::string path = (std::filesystem::temp_directory_path() / "bpl_trace_test.json").string();
+
+    bool wasEnabled = Trace::enabled();
+
+    Trace::enable (path);
+    Trace::instance().clear();
+
+    std::vector<uint32_t> v (10000, 1);
+
+    Launcher<ArchMulticore> launcher (4_thread);
+    REQUIRE (launcher.run<VectorChecksum> (split(v)) == v.size());
+
+    // One event for the run, one per job and one per split.
+    REQUIRE (Trace::instance().getNbEvents() == 1 + 4 + 4);
+
+    {
+        Trace::Scope scope ("host \"side\"", "test");
+    }
+
+    REQUIRE (Trace::instance().flush());
+
+    std::ifstream is (path);
+    std::stringstream ss;
+    ss << is.rdbuf();
+    std::string content = ss.str();
+
+    auto count = [&] (const std::string& pattern)
+    {
+        size_t nb = 0;
+        for (size_t pos=content.find(pattern); pos!=std::string::npos; pos=content.find(pattern,pos+1))  { nb++; }
+        return nb;
+    };
+
+    REQUIRE (content.starts_with ("{\"traceEvents\":["));
+    REQUIRE (count ("\"ph\":\"X\"")            == 10);
+    REQUIRE (count ("\"name\":\"job\"")        == 4);
+    REQUIRE (count ("\"name\":\"split\"")      == 4);
+    REQUIRE (count ("\"cat\":\"run\"")         == 1);
+    REQUIRE (count ("host \\\"side\\\"")        == 1);
+    for (size_t i=0; i<4; i++)  {  REQUIRE (count ("\"unit\":" + std::to_string(i) + "}") == 2);  }
+
+    // No more events once disabled.
+    Trace::disable();
+    Trace::instance().clear();
+    launcher.run<VectorChecksum> (split(v));
+    REQUIRE (Trace::instance().getNbEvents() == 0);
+
+    if (wasEnabled)  {  Trace::enable (path);  }
+    std::filesystem::remove (path);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE ("Trace threads", "[Trace]" )
+{
+    // Each thread gets its own identifier.
+    size_t nbThreads = 64;
+    std::vector<uint64_t> ids (nbThreads);
+    std::vector<std::thread> threads;
+    for (size_t i=0; i<nbThreads; i++)  {  threads.emplace_back ([&ids,i]  {  ids[i] = Trace::getThreadId();  });  }
+    for (auto& t : threads)  { t.join(); }
+
+    ids.push_back (Trace::getThreadId());
+    REQUIRE (Trace::getThreadId() == ids.back());
+    std::sort (ids.begin(), ids.end());
+    REQUIRE (std::adjacent_find (ids.begin(), ids.end()) == ids.end());
+
+    // The events beyond the limit of a thread are dropped.
+    auto& trace = Trace::instance();
+    size_t maxEvents = Trace::getMaxEventsPerThread();
+    Trace::setMaxEventsPerThread (100);
+    trace.clear();
+
+    std::thread ([&]  {  for (size_t i=0; i<150; i++)  {  trace.record ("event", "test", i, i+1);  }  }).join();
+    for (size_t i=0; i<30; i++)  {  trace.record ("event", "test", i, i+1);  }
+
+    REQUIRE (trace.getNbEvents()  == 130);
+    REQUIRE (trace.getNbDropped() == 50);
+
+    // The events of the thread that exited are released.
+    trace.clear();
+    REQUIRE (trace.getNbEvents()  == 0);
+    REQUIRE (trace.getNbDropped() == 0);
+
+    Trace::setMaxEventsPerThread (maxEvents);
+}
@@ -383,6 +383,78 @@ TEST_CASE ("VectorChecksum", "[Vector]" )
 {
     config::run<VectorChecksum_aux> ();
 }
+//////////////////////////////////////////////////////////////////////////////
+template<class ARCH>
+struct VectorViewZeroCopy : bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    // We return the addresses of the items seen by the task.
+    auto operator() (vector_view<uint32_t> const& part, std::vector<uint32_t> const& whole)
+    {
+        return std::make_tuple (uintptr_t(part.data()), part.size(), uintptr_t(whole.data()));
+    }
+};
+
+TEST_CASE ("VectorViewZeroCopy", "[Vector]" )
+{
+    std::vector<uint32_t> v (100000);
+    std::vector<uint32_t> w (10);
+
+    for (size_t granularity : {1, 4})
+    {
+        ArchMulticore arch (8_thread, 4_thread, false, false, granularity);
+
+        auto results = arch.run<VectorViewZeroCopy> (split(v), w);
+        REQUIRE (results.size() == 8*granularity);
+
+        // The parts are views on the split vector and the other vector is passed by reference.
+        uintptr_t next = uintptr_t (v.data());
+        for (auto [part,size,whole] : results)
+        {
+            REQUIRE (part  == next);
+            REQUIRE (whole == uintptr_t (w.data()));
+            next += size*sizeof(uint32_t);
+        }
+        REQUIRE (next == uintptr_t (v.data()+v.size()));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+template<class ARCH>
+struct VectorSquareOutput : bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    // The squares are written in place into the part of the caller buffer; we only return the number of items.
+    auto operator() (vector_view<uint32_t> const& in, output<span<uint64_t>> out)
+    {
+        for (size_t i=0; i<in.size(); i++)  {  (*out)[i] = uint64_t(in[i])*in[i];  }
+        return out->size();
+    }
+
+    static auto reduce (size_t a, size_t b)  { return a+b; }
+};
+
+TEST_CASE ("VectorSquareOutput", "[Vector]" )
+{
+    for (size_t n : {1, 7, 1000, 100001})
+    {
+        std::vector<uint32_t> v (n);
+        for (size_t i=0; i<n; i++)  {  v[i] = i;  }
+
+        for (size_t granularity : {1, 3})
+        {
+            Launcher<ArchMulticore> launcher (8_thread, 4_thread, false, false, granularity);
+
+            std::vector<uint64_t> squares (n, 0);
+            REQUIRE (launcher.run<VectorSquareOutput> (split(v), split(squares)) == n);
+
+            for (size_t i=0; i<n; i++)  {  REQUIRE (squares[i] == uint64_t(i)*i);  }
+        }
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 TEST_CASE ("VectorChecksumOnce", "[Vector]" )
 {
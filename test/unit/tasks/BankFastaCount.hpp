@@ -0,0 +1,39 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics 
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <bpl/core/Task.hpp>
+#include <bpl/bank/BankFasta.hpp>
+
+////////////////////////////////////////////////////////////////////////////////
+// @description: Takes a FASTA/FASTQ bank (or a part of it) and counts the
+// number of records and the number of nucleotides.
+////////////////////////////////////////////////////////////////////////////////
+template<class ARCH>
+struct BankFastaCount : bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    auto operator() (const bpl::BankFastaView& bank)
+    {
+        uint64_t nbRecords     = 0;
+        uint64_t nbNucleotides = 0;
+
+        for (auto&& record : bank)
+        {
+            nbRecords     ++;
+            nbNucleotides += record.size();
+        }
+
+        return std::make_pair (nbRecords, nbNucleotides);
+    }
+
+    static auto reduce (std::pair<uint64_t,uint64_t> a, std::pair<uint64_t,uint64_t> b)
+    {
+        return std::make_pair (a.first+b.first, a.second+b.second);
+    }
+};
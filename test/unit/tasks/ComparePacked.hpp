@@ -0,0 +1,55 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics 
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <bpl/bank/BankChunk.hpp>
+
+using namespace bpl;
+
+////////////////////////////////////////////////////////////////////////////////
+// @description: same as Compare1 but with 2 bits nucleotides, the number of
+// common nucleotides being computed 32 nucleotides at once.
+////////////////////////////////////////////////////////////////////////////////
+template<class ARCH>
+struct ComparePacked
+{
+    USING(ARCH);
+
+    static const int NBREF  = 64;
+    static const int NBQRY  = 32;
+
+    static const int SEQLEN = 32;
+
+    using sequence_t = PackedSequence<SEQLEN>;
+
+    auto operator() (
+        const BankChunk<ARCH,SEQLEN,NBREF,sequence_t>& ref,
+        const BankChunk<ARCH,SEQLEN,NBQRY,sequence_t>& qry,
+        pair<int,int> range,
+        size_t threshold
+    )
+    {
+        size_t nbFound = 0;
+
+        for (int n=1; n<=20; n++)
+        {
+            for (auto&& s1 : ref)
+            {
+                for (auto&& s2 : slice(qry,range))
+                {
+                    size_t common = sequence_t::nbCommon (s1,s2);
+
+                    if (100*common >= threshold * SEQLEN)  {  nbFound ++;  }
+                }
+            }
+        }
+
+        return nbFound;
+    }
+
+    static auto reduce (size_t a, size_t b)  {  return a+b;  }
+};
@@ -0,0 +1,19 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics 
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <bpl/core/Task.hpp>
+
+template<class ARCH>
+struct GetPuidSplit : bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    using range_t = pair<uint64_t,uint64_t>;
+
+    size_t operator() (range_t range)    { return this->tuid();  }
+};
@@ -0,0 +1,24 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics 
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <bpl/core/Task.hpp>
+
+////////////////////////////////////////////////////////////////////////////////
+// @description: Each process unit returns its uid plus one and the partial
+// results are reduced with a 'min'. The default value of the result (0) is not
+// an identity element for 'min', so the reduction must not be seeded with it.
+////////////////////////////////////////////////////////////////////////////////
+template<class ARCH>
+struct ReduceMin : bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    uint32_t operator() () const  {  return this->tuid() + 1;  }
+
+    static uint32_t reduce (uint32_t a, uint32_t b)  {  return std::min (a,b);  }
+};
@@ -0,0 +1,32 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics 
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <bpl/core/Task.hpp>
+
+////////////////////////////////////////////////////////////////////////////////
+// @description: Each process unit returns its own uid and the partial results
+// are concatenated. The 'reduce' function is associative but not commutative,
+// so the final vector is sorted only if the unit order is kept by the reduction.
+////////////////////////////////////////////////////////////////////////////////
+template<class ARCH>
+struct ReduceOrdered : bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    auto operator() () const
+    {
+        return vector<uint32_t> { uint32_t(this->tuid()) };
+    }
+
+    static auto reduce (vector<uint32_t> const& a, vector<uint32_t> const& b)
+    {
+        vector<uint32_t> result (a);
+        result.insert (result.end(), b.begin(), b.end());
+        return result;
+    }
+};
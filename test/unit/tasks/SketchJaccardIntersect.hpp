@@ -0,0 +1,47 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics 
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <bpl/core/Task.hpp>
+#include <bpl/utils/intersect.hpp>
+
+////////////////////////////////////////////////////////////////////////////////
+// @description: same as SketchJaccardDistance but two sketches are compared
+// with the SIMD intersection kernel (multicore only).
+////////////////////////////////////////////////////////////////////////////////
+template<class ARCH>
+struct SketchJaccardIntersect : bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    using hash_t   = uint32_t;
+    using count_t  = uint16_t;
+
+    auto operator() (
+        const vector_view<hash_t>& dbRef,
+        const vector_view<hash_t>& dbQry,
+        size_t ssize
+    )
+    {
+        size_t nbSketchRef = dbRef.size() / ssize;
+        size_t nbSketchQry = dbQry.size() / ssize;
+
+        vector<count_t> result (nbSketchRef*nbSketchQry);
+
+        size_t k=0;
+
+        for (size_t offsetQry=0; offsetQry<nbSketchQry*ssize; offsetQry+=ssize)
+        {
+            for (size_t offsetRef=0; offsetRef<nbSketchRef*ssize; offsetRef+=ssize)
+            {
+                result[k++] = bpl::intersect_count (dbRef.data()+offsetRef, ssize, dbQry.data()+offsetQry, ssize);
+            }
+        }
+
+        return result;
+    }
+};
@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics 
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <bpl/core/Task.hpp>
+#include <bpl/utils/TopK.hpp>
+
+#ifndef DPU
+#include <stdexcept>
+#include <string>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// @description: Top-K search of the reference sketches the closest to each
+// query sketch. Instead of the nbSketchRef*nbSketchQry counts, each unit
+// returns the K best (ref id, count) items of each query; the partial results
+// are then merged on host side with bpl::mergeTopK.
+// @remark: 'range' is the split of the range [0,dbRef.size()) made exactly as
+// the split of dbRef, so it gives the offset of the part of dbRef, hence the
+// identifier of its first reference sketch. The split of dbRef must not cut a
+// sketch (see the weighted split in TestSketch.cpp).
+// @remark: a part of dbRef that doesn't match its range or cuts a sketch, and
+// a K greater than KMAX, make the task fail (an exception on host, a fault on
+// DPU) instead of returning wrong identifiers or a truncated top-K.
+////////////////////////////////////////////////////////////////////////////////
+template<class ARCH>
+struct SketchJaccardTopKHeap : bpl::Task<ARCH>
+{
+    struct config  {
+        static const int VECTOR_MEMORY_SIZE_LOG2 = 10;
+        static const bool VECTOR_SERIALIZE_OPTIM = true;
+    };
+
+    USING(ARCH,config);
+
+    using hash_t   = uint32_t;
+    using count_t  = uint16_t;
+    using item_t   = bpl::TopKItem<uint32_t,count_t>;
+
+    static constexpr size_t KMAX = 32;
+
+    auto operator() (
+        const vector_view<hash_t>& dbRef,
+        const pair<uint32_t,uint32_t>& range,
+        const vector_view<hash_t>& dbQry,
+        size_t ssize,
+        uint32_t K
+    )
+    {
+        auto refStart = dbRef.begin();
+        auto qryStart = dbQry.begin();
+
+        if (K > KMAX)  {  fail ("K greater than KMAX");  }
+
+        if (dbRef.size() != range.second-range.first or range.first % ssize != 0 or dbRef.size() % ssize != 0)
+        {
+            fail ("the split of dbRef must match its range and hold whole sketches");
+        }
+
+        size_t nbSketchRef = dbRef.size() / ssize;
+        size_t nbSketchQry = dbQry.size() / ssize;
+
+        uint32_t firstId = range.first / ssize;
+
+        vector<item_t> result;
+
+        bpl::TopK<item_t,KMAX> topk (K);
+
+        for (size_t idxSketchQry=0, offsetQry=0; idxSketchQry<nbSketchQry; idxSketchQry++, offsetQry+=ssize)
+        {
+            for (size_t idxSketchRef=0, offsetRef=0; idxSketchRef<nbSketchRef; idxSketchRef++, offsetRef+=ssize)
+            {
+                count_t count = 0;
+
+                auto refBegin = refStart + offsetRef;
+                auto refEnd   = dbRef.end() - (dbRef.size()-(offsetRef + ssize));
+
+                auto qryBegin = qryStart + offsetQry;
+                auto qryEnd   = dbQry.end() - (dbQry.size()-(offsetQry + ssize));
+
+                while (true)  // loop that compares two sketches
+                {
+                        if (*refBegin < *qryBegin)   {   if (++refBegin == refEnd)  { break; }   }
+                   else if (*refBegin > *qryBegin)   {   if (++qryBegin == qryEnd)  { break; }   }
+                   else
+                   {
+                       count++;
+                       if (++refBegin == refEnd)  { break; }
+                       if (++qryBegin == qryEnd)  { break; }
+                   }
+                }
+
+                topk.insert (item_t { uint32_t(firstId + idxSketchRef), count });
+            }
+
+            // Only K items per query are kept.
+            topk.flush (result);
+        }
+
+        return result;
+    }
+
+private:
+
+    [[noreturn]] static void fail ([[maybe_unused]] const char* message)
+    {
+#ifdef DPU
+        __builtin_trap();
+#else
+        throw std::invalid_argument (std::string("SketchJaccardTopKHeap: ") + message);
+#endif
+    }
+};
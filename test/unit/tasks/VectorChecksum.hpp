@@ -19,7 +19,7 @@ struct VectorChecksum : bpl::Task<ARCH>
 {
     USING(ARCH);
 
-    auto operator() (vector<uint32_t> const& v)
+    auto operator() (vector_view<uint32_t> const& v)
     {
         uint64_t checksum = 0;
         for (auto x : v)  {  checksum += x;  }
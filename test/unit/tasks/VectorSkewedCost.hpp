@@ -0,0 +1,36 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics 
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <bpl/core/Task.hpp>
+
+////////////////////////////////////////////////////////////////////////////////
+// @description: Takes a vector of lengths as input and, for each length, does
+// a number of iterations equal to this length (like processing a sequence
+// of this length). The final result is the reduced checksum.
+// @benchmark-input: 2^n for n in 14,16,18
+// @benchmark-split: yes (by count or weighted by the lengths)
+////////////////////////////////////////////////////////////////////////////////
+template<class ARCH>
+struct VectorSkewedCost : bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    auto operator() (vector<uint32_t> const& lengths)
+    {
+        uint64_t checksum = 0;
+        for (auto len : lengths)
+        {
+            uint32_t h = len;
+            for (uint32_t i=0; i<len; i++)  {  h = h*1664525 + 1013904223;  }
+            checksum += h;
+        }
+        return checksum;
+    }
+
+    static uint64_t reduce (uint64_t a, uint64_t b)  { return a+b; }
+};
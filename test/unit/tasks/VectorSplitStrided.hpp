@@ -0,0 +1,29 @@
+////////////////////////////////////////////////////////////////////////////////
+// BPL, the Process In Memory library for bioinformatics 
+// date  : 2026
+// author: edrezen
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <bpl/utils/StridedView.hpp>
+
+////////////////////////////////////////////////////////////////////////////////
+// @description: The task takes the RAKE/RAND part of a vector as a strided view,
+// so the multicore architecture provides the part without gathering its items.
+////////////////////////////////////////////////////////////////////////////////
+template<class ARCH>
+struct VectorSplitStrided : public bpl::Task<ARCH>
+{
+    USING(ARCH);
+
+    using value_type = uint32_t;
+
+    uint64_t operator() (bpl::strided_view<const value_type> const& v) const  {
+        uint64_t result = 0;
+        for (auto x : v)  {  result += x;  }
+        return result;
+    }
+
+    static auto reduce (uint64_t a, uint64_t b)  { return a+b; }
+};